@@ -0,0 +1,331 @@
+//===================================================================================================================
+// bench.cc -- Microbenchmarks for the code that ast-cc generates
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// This program is compiled once for each spec that is benchmarked, against the nodes ast-cc generated for it and
+// the bench-spec.hh that goes with it.  It builds a balanced tree of the requested number of nodes through the
+// Factory() functions and times the common operations on it.
+//
+// Each benchmark prints one line of name=value pairs, always the same names in the same order, so the output of
+// two runs (say, before and after a change to the generator) can be compared line by line.  The times are the
+// best of several repetitions, in nanoseconds per node (or per call).  The memory is counted by replacing the
+// global operator new, so it is the bytes the nodes actually asked for.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+#include "bench-spec.hh"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+
+//
+// -- The allocation counters.  g++ warns about free() on memory from operator new when it inlines the replaced
+//    operator delete, so it is kept out of line.
+//    ---------------------------------------------------------------------------------------------------------
+static size_t allocBytes = 0;
+static size_t allocCount = 0;
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+void *operator new(size_t size)
+{
+    void *rv = malloc(size ? size : 1);
+
+    if (!rv) throw std::bad_alloc();
+    allocBytes += size;
+    allocCount ++;
+    return rv;
+}
+
+BENCH_NOINLINE void operator delete(void *p) noexcept { free(p); }
+
+
+//
+// -- The benchmark parameters and the place to keep a result the compiler cannot throw away
+//    --------------------------------------------------------------------------------------
+static size_t nodeCount = 1000000;
+static int reps = 5;
+static volatile long sink;
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Now() -- Get the current time in nanoseconds
+//-------------------------------------------------------------------------------------------------------------------
+static double Now(void)
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Report() -- Print the result of one benchmark
+//-------------------------------------------------------------------------------------------------------------------
+static void Report(const char *bench, size_t n, const char *unit, double value)
+{
+    printf("spec=%s bench=%s n=%zu %s=%.2f\n", BENCH_SPEC, bench, n, unit, value);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Build() -- Build a balanced tree from the leaves up; all holds every node, with the root last
+//
+// The leaves go in first, then each pair of nodes from the front of the queue is joined under a new inner node
+// until only the root is left.  all is sized up front so that it does not allocate while the nodes are counted.
+//-------------------------------------------------------------------------------------------------------------------
+static BenchNode *Build(std::vector<BenchNode *> &all, size_t leaves)
+{
+    size_t head = 0;
+
+    all.clear();
+    for (size_t i = 0; i < leaves; i ++) all.push_back(BenchLeaf((long)i));
+
+    while (all.size() - head > 1) {
+        all.push_back(BenchInner((long)all.size(), all[head], all[head + 1]));
+        head += 2;
+    }
+
+    return all.back();
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Destroy() -- Delete every node of a tree built by Build(), root first
+//-------------------------------------------------------------------------------------------------------------------
+static void Destroy(std::vector<BenchNode *> &all)
+{
+    for (size_t i = all.size(); i > 0; i --) delete all[i - 1];
+    all.clear();
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// main() -- Run the benchmarks: bench [nodes [repetitions]]
+//-------------------------------------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    if (argc > 1) nodeCount = strtoul(argv[1], NULL, 10);
+    if (argc > 2) reps = atoi(argv[2]);
+    if (nodeCount < 2) nodeCount = 2;
+    if (reps < 1) reps = 1;
+
+    size_t leaves = (nodeCount + 1) / 2;
+    std::vector<BenchNode *> all;
+    std::vector<BenchNode *> leafList;
+    BenchNode *tree = NULL;
+    double best, t;
+    size_t n = 0;
+
+    all.reserve(leaves * 2);
+    leafList.reserve(leaves);
+
+    //
+    // -- Build the trees through Factory(), counting the memory the last time through
+    //    ----------------------------------------------------------------------------
+    best = 0;
+
+    for (int r = 0; r < reps; r ++) {
+        if (tree) Destroy(all);
+
+        size_t bytes = allocBytes, count = allocCount;
+
+        t = Now();
+        tree = Build(all, leaves);
+        t = Now() - t;
+        n = all.size();
+
+        if (r == 0 || t < best) best = t;
+        if (r == reps - 1) {
+            Report("build", n, "ns_per_node", best / n);
+            Report("memory", n, "bytes_per_node", (double)(allocBytes - bytes) / n);
+            Report("allocs", n, "allocs_per_node", (double)(allocCount - count) / n);
+        }
+    }
+
+    for (size_t i = 0; i < leaves; i ++) leafList.push_back(all[i]);
+
+    //
+    // -- Walk the tree with the generated iterators
+    //    ------------------------------------------
+    best = 0;
+
+    for (int r = 0; r < reps; r ++) {
+        long c = 0;
+
+        t = Now();
+        for (ASTPreorder it(tree); it.Current(); it.Next()) c ++;
+        t = Now() - t;
+
+        sink = c;
+        if (r == 0 || t < best) best = t;
+    }
+
+    Report("preorder", n, "ns_per_node", best / n);
+
+    best = 0;
+
+    for (int r = 0; r < reps; r ++) {
+        long c = 0;
+
+        t = Now();
+        for (ASTPostorder it(tree); it.Current(); it.Next()) c ++;
+        t = Now() - t;
+
+        sink = c;
+        if (r == 0 || t < best) best = t;
+    }
+
+    Report("postorder", n, "ns_per_node", best / n);
+
+    //
+    // -- Find the type of each node, through the virtual function and through the stored tag
+    //    -----------------------------------------------------------------------------------
+    best = 0;
+
+    for (int r = 0; r < reps; r ++) {
+        long c = 0;
+
+        t = Now();
+        for (size_t i = 0; i < n; i ++) c += all[i]->_GetType();
+        t = Now() - t;
+
+        sink = c;
+        if (r == 0 || t < best) best = t;
+    }
+
+    Report("gettype", n, "ns_per_node", best / n);
+
+    best = 0;
+
+    for (int r = 0; r < reps; r ++) {
+        long c = 0;
+
+        t = Now();
+        for (size_t i = 0; i < n; i ++) c += all[i]->_GetTag();
+        t = Now() - t;
+
+        sink = c;
+        if (r == 0 || t < best) best = t;
+    }
+
+    Report("gettag", n, "ns_per_node", best / n);
+
+    //
+    // -- Read and write an attribute of every leaf
+    //    -----------------------------------------
+    best = 0;
+
+    for (int r = 0; r < reps; r ++) {
+        long c = 0;
+
+        t = Now();
+        for (size_t i = 0; i < leaves; i ++) c += BenchGet(leafList[i]);
+        t = Now() - t;
+
+        sink = c;
+        if (r == 0 || t < best) best = t;
+    }
+
+    Report("get", leaves, "ns_per_call", best / leaves);
+
+    best = 0;
+
+    for (int r = 0; r < reps; r ++) {
+        t = Now();
+        for (size_t i = 0; i < leaves; i ++) BenchSet(leafList[i], (Int)((i + r) & 1));
+        t = Now() - t;
+
+        if (r == 0 || t < best) best = t;
+    }
+
+    Report("set", leaves, "ns_per_call", best / leaves);
+
+    //
+    // -- Evaluate the tree through the virtual methods, then flattened
+    //    -------------------------------------------------------------
+    Int expect = 0;
+    best = 0;
+
+    for (int r = 0; r < reps; r ++) {
+        t = Now();
+        expect = BenchCalc(tree);
+        t = Now() - t;
+
+        if (r == 0 || t < best) best = t;
+    }
+
+    Report("calc", n, "ns_per_node", best / n);
+
+    ASTFlat<BenchNode> flat;
+    best = 0;
+
+    for (int r = 0; r < reps; r ++) {
+        t = Now();
+        flat.Assign(tree);
+        t = Now() - t;
+
+        if (r == 0 || t < best) best = t;
+    }
+
+    Report("flatten", n, "ns_per_node", best / n);
+
+    BenchEval e;
+    std::vector<BenchEval::Value> v;
+    best = 0;
+
+    for (int r = 0; r < reps; r ++) {
+        Int got;
+
+        t = Now();
+        got = flat.Eval(e, v);
+        t = Now() - t;
+
+        if (got != expect) {
+            fprintf(stderr, "Error: the flattened evaluation gave %ld, not %ld\n", (long)got, (long)expect);
+            return EXIT_FAILURE;
+        }
+
+        if (r == 0 || t < best) best = t;
+    }
+
+    Report("eval", n, "ns_per_node", best / n);
+
+    //
+    // -- Finally, tear the tree down
+    //    ---------------------------
+    t = Now();
+    Destroy(all);
+    t = Now() - t;
+
+    Report("destroy", n, "ns_per_node", t / n);
+
+    return EXIT_SUCCESS;
+}
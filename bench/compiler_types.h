@@ -0,0 +1,57 @@
+//===================================================================================================================
+// compiler_types.h -- The types that the sample and the synthetic specs name, for the benchmarks
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+#ifndef __COMPILER_TYPES_H__
+#define __COMPILER_TYPES_H__
+
+#include <string>
+
+typedef long Int;
+typedef std::string String;
+
+
+//
+// -- A symbol as the sample's Ident node uses it
+//    -------------------------------------------
+struct SymbolRec {
+    std::string name;
+    Int value;
+
+    std::string GetName(void) { return name; }
+    Int GetValue(void) { return value; }
+};
+
+typedef SymbolRec *Symbol;
+
+
+//
+// -- These would be maintained by the parser
+//    ---------------------------------------
+static int yylineno = 1;
+static String filename = "bench.src";
+
+#endif
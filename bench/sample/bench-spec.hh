@@ -0,0 +1,90 @@
+//===================================================================================================================
+// bench-spec.hh -- Connect the benchmarks to the nodes generated from sample/sample.ast
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Each spec that is benchmarked supplies this file (the one for a synthetic spec is written by synth.awk along
+// with the spec).  It names the node type the trees are built from and wraps the Factory() functions and
+// attribute accessors of the spec, so bench.cc can be written once for all of them.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+#include "ast-nodes.hh"
+
+#define BENCH_SPEC "sample"
+
+typedef Expression BenchNode;
+
+
+//
+// -- The external methods of the sample
+//    ----------------------------------
+void Calculation::Semant(void) {}
+void Add::Semant(void) {}
+void Sub::Semant(void) {}
+void Mul::Semant(void) {}
+void Div::Semant(void) {}
+void Mod::Semant(void) {}
+void Neg::Semant(void) {}
+
+
+//
+// -- Build the leaves and the inner nodes (the kind is any number; only Add and Sub are used so the
+//    calculation cannot overflow or divide by zero)
+//    ----------------------------------------------------------------------------------------------
+static inline BenchNode *BenchLeaf(long i) { return Nbr::Factory(i & 1); }
+static inline BenchNode *BenchInner(long k, BenchNode *l, BenchNode *r)
+{
+    if (k & 1) return Sub::Factory(l, r);
+    return Add::Factory(l, r);
+}
+
+
+//
+// -- Read and write an attribute of a leaf
+//    -------------------------------------
+static inline Int BenchGet(BenchNode *leaf) { return static_cast<Nbr *>(leaf)->Get_value(); }
+static inline void BenchSet(BenchNode *leaf, Int v) { static_cast<Nbr *>(leaf)->Set_value(v); }
+
+
+//
+// -- Evaluate the tree through the virtual methods
+//    ---------------------------------------------
+static inline Int BenchCalc(BenchNode *tree) { return tree->Calc(); }
+
+
+//
+// -- Evaluate the flattened tree
+//    ---------------------------
+struct BenchEval {
+    typedef Int Value;
+
+    Int Eval_Ident(const ASTFlat<Expression>::Ident_Payload &p) { return p.sym->GetValue(); }
+    Int Eval_Nbr(const ASTFlat<Expression>::Nbr_Payload &p) { return p.value; }
+    Int Eval_Add(const Int &l, const Int &r) { return l + r; }
+    Int Eval_Sub(const Int &l, const Int &r) { return l - r; }
+    Int Eval_Mul(const Int &l, const Int &r) { return l * r; }
+    Int Eval_Div(const Int &l, const Int &r) { return l / r; }
+    Int Eval_Mod(const Int &l, const Int &r) { return l % r; }
+    Int Eval_Neg(const Int &o) { return -o; }
+};
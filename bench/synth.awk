@@ -0,0 +1,94 @@
+#####################################################################################################################
+##                                                                                                                 ##
+## synth.awk -- Write a synthetic spec for the benchmarks, along with its bench-spec.hh                            ##
+##                                                                                                                 ##
+## Usage: awk -v kinds=K -v attrs=A -v dir=DIR -f synth.awk                                                        ##
+##                                                                                                                 ##
+## The spec has a leaf node and K binary node types, each with A attributes besides its two children, so the size  ##
+## of the node classes and the number of node types can be scaled well past the sample.                            ##
+##                                                                                                                 ##
+##    Date     Tracker  Version  Pgmr  Modification                                                                ##
+## ----------  -------  -------  ----  --------------------------------------------------------------------------- ##
+## 2026-10-18    N/A    v0.1.1   ADCL  Initial version                                                             ##
+##                                                                                                                 ##
+#####################################################################################################################
+
+BEGIN {
+    if (kinds < 1) kinds = 16;
+    if (attrs < 0) attrs = 0;
+    if (dir == "") dir = ".";
+
+    ast = dir "/synth.ast";
+    hh = dir "/bench-spec.hh";
+
+    #
+    # -- The spec: the node declarations first, then the attributes and methods
+    #    ----------------------------------------------------------------------
+    print "// synth.ast -- synthetic spec with " kinds " binary node types of " attrs " extra attributes each" > ast;
+    print "node Base : Common abstract flatten;" > ast;
+    print "node Binary : Base abstract;" > ast;
+    print "node Leaf : Base;" > ast;
+    for (k = 0; k < kinds; k ++) print "node Op" k " : Binary;" > ast;
+    print "type Int;" > ast;
+    print "type String;" > ast;
+    print "include \"compiler_types.h\"" > ast;
+    print "%%" > ast;
+    print "attr Common::line : Int no-init(yylineno);" > ast;
+    print "attr Common::file : String interned no-init(filename);" > ast;
+    print "meth Base::Calc(void) : Int abstract;" > ast;
+    print "attr Binary::left : Base;" > ast;
+    print "attr Binary::right : Base;" > ast;
+    print "attr Leaf::value : Int;" > ast;
+    print "meth Leaf::Calc(void) : Int { return value; }" > ast;
+
+    for (k = 0; k < kinds; k ++) {
+        sum = "";
+        for (a = 0; a < attrs; a ++) {
+            print "attr Op" k "::a" a " : Int no-init(0);" > ast;
+            sum = sum " + a" a;
+        }
+        print "meth Op" k "::Calc(void) : Int { return left->Calc() " (k % 2 ? "-" : "+") " right->Calc()" sum "; }" > ast;
+    }
+
+    print "%%" > ast;
+
+    #
+    # -- The glue for bench.cc
+    #    ---------------------
+    print "// bench-spec.hh -- connect the benchmarks to the nodes generated from synth.ast" > hh;
+    print "#include \"ast-nodes.hh\"" > hh;
+    print "" > hh;
+    print "#define BENCH_SPEC \"synth" kinds "\"" > hh;
+    print "" > hh;
+    print "typedef Base BenchNode;" > hh;
+    print "" > hh;
+    print "static inline BenchNode *BenchLeaf(long i) { return Leaf::Factory(i & 1); }" > hh;
+    print "static inline BenchNode *BenchInner(long k, BenchNode *l, BenchNode *r)" > hh;
+    print "{" > hh;
+    print "    switch (k % " kinds ") {" > hh;
+    for (k = 0; k < kinds; k ++) print "    case " k ": return Op" k "::Factory(l, r);" > hh;
+    print "    default: return NULL;" > hh;
+    print "    }" > hh;
+    print "}" > hh;
+    print "" > hh;
+    print "static inline Int BenchGet(BenchNode *leaf) { return static_cast<Leaf *>(leaf)->Get_value(); }" > hh;
+    print "static inline void BenchSet(BenchNode *leaf, Int v) { static_cast<Leaf *>(leaf)->Set_value(v); }" > hh;
+    print "static inline Int BenchCalc(BenchNode *tree) { return tree->Calc(); }" > hh;
+    print "" > hh;
+    print "struct BenchEval {" > hh;
+    print "    typedef Int Value;" > hh;
+    print "" > hh;
+    print "    Int Eval_Leaf(const ASTFlat<Base>::Leaf_Payload &p) { return p.value; }" > hh;
+
+    for (k = 0; k < kinds; k ++) {
+        sum = "";
+        for (a = 0; a < attrs; a ++) sum = sum " + p.a" a;
+        print "    Int Eval_Op" k "(" (attrs ? "const ASTFlat<Base>::Op" k "_Payload &p, " : "") \
+                "const Int &l, const Int &r) { return l " (k % 2 ? "-" : "+") " r" sum "; }" > hh;
+    }
+
+    print "};" > hh;
+
+    close(ast);
+    close(hh);
+}
@@ -30,6 +30,30 @@
 //    Date     Tracker  Version  Pgmr  Modification
 // ----------  -------  -------  ----  -----------------------------------------------------------------------------
 // 2016-03-27    N/A     v0.1    ADCL  second version of the ast language
+// 2026-10-18    N/A    v0.1.1   ADCL  Initialize the Node lists; add helpers to identify child attributes
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the code generation options
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the rewrite rules and their patterns
+// 2026-10-18    N/A    v0.1.1   ADCL  Add computed attributes
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --parents option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --stats option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --trace option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add immutable nodes
+// 2026-10-18    N/A    v0.1.1   ADCL  Add owned attributes
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --variant option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add interned attributes and the location type
+// 2026-10-18    N/A    v0.1.1   ADCL  Add bits(N) attributes
+// 2026-10-18    N/A    v0.1.1   ADCL  Add flattened node families
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --ids option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add lazy attributes
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --index option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add literal nodes and literal trees
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --dump option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --digest option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --clone option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --final option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --shm option
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the version and the input stamp
+// 2026-10-18    N/A    v0.1.1   ADCL  Keep the declaration order of the nodes in declOrder
 //
 //===================================================================================================================
 
@@ -37,6 +61,14 @@
 #include "lists.hh"
 #include <string>
 
+
+//
+// -- the version of ast-cc, which is part of the input stamp (the makefile passes the one it builds)
+//    -----------------------------------------------------------------------------------------------
+#ifndef AST_CC_VERSION
+#define AST_CC_VERSION "0.1.1"
+#endif
+
 extern char *endingCode;
 
 //
@@ -57,9 +89,48 @@ typedef enum {
     INLINE      = 0x0040,
     EXTERNAL    = 0x0080,
     NOINIT      = 0x0100,
+    COMPUTED    = 0x0200,
+    IMMUTABLE   = 0x0400,
+    OWNED       = 0x0800,
+    INTERNED    = 0x1000,
+    BITS        = 0x2000,
+    FLATTEN     = 0x4000,
+    LAZY        = 0x8000,
+    LITERAL     = 0x10000,
+    FINAL       = 0x20000,
+    NONVIRTUAL  = 0x40000,
 } Flags;
 
 
+//
+// -- the width of a bits(N) attribute is carried in the top of its flags
+//    -------------------------------------------------------------------
+const int BITS_SHIFT = 24;
+
+
+//
+// -- the code generation options, which are set from the command line (or the source for OPT_IMMUTABLE)
+//    ---------------------------------------------------------------------------------------------------
+typedef enum {
+    OPT_NONE        = 0x0000,
+    OPT_PARALLEL    = 0x0001,
+    OPT_PARENTS     = 0x0002,
+    OPT_STATS       = 0x0004,
+    OPT_TRACE       = 0x0008,
+    OPT_IMMUTABLE   = 0x0010,
+    OPT_VARIANT     = 0x0020,
+    OPT_IDS         = 0x0040,
+    OPT_INDEX       = 0x0080,
+    OPT_DUMP        = 0x0100,
+    OPT_DIGEST      = 0x0200,
+    OPT_CLONE       = 0x0400,
+    OPT_FINAL       = 0x0800,
+    OPT_SHM         = 0x1000,
+} Options;
+
+extern int options;
+
+
 //
 // -- kinds of symbols we can define
 //    ------------------------------
@@ -142,10 +213,25 @@ extern SymTable *symtab;
 //
 // -- Function prototypes
 //    -------------------
+class Node;
+
 Symbol *AddTypeSymbol(const std::string &n);
 Symbol *AddNodeSymbol(const std::string &n);
 bool LookupSymbol(const std::string &n);
 Symbol *GetSymbol(const std::string &n);
+Node *GetRootNode(void);
+Node *GetNode(Symbol *s);
+bool HasComputedAttrs(void);
+bool NeedParentLinks(void);
+bool HasImmutableNodes(void);
+bool HasOwnedAttrs(void);
+bool HasInternedAttrs(void);
+bool HasBitsAttrs(void);
+bool HasFlatNodes(void);
+bool HasLazyAttrs(void);
+bool HasLiteralNodes(void);
+bool IsLiteralBase(Node *n);
+bool UsesLocation(void);
 
 
 //-------------------------------------------------------------------------------------------------------------------
@@ -196,6 +282,12 @@ private:
 public:
     void Set_Code(const std::string &c) { code = c; }
     std::string &Get_Code(void) { return code; }
+
+public:
+    bool Is_Child(void) { return type && type->Get_Kind() == NODE && !(flags & (STATIC | COMPUTED | LAZY)); }
+
+public:
+    int Get_Bits(void) const { return (flags & BITS) ? ((flags >> BITS_SHIFT) & 0x7f) : 0; }
 };
 
 
@@ -362,7 +454,7 @@ public:
     AttrList *Get_Attrs(void) { return attrs; }
 
 protected:
-    Node(Node *p, Symbol *n) : flags(NONE), parent(p), name(n) {}
+    Node(Node *p, Symbol *n) : flags(NONE), parent(p), name(n), methods(NULL), attrs(NULL) {}
 
 public:
     static Node *Factory(Node *p, Symbol *n) { return new Node(p, n); }
@@ -375,15 +467,272 @@ public:
 
 public:
     virtual int GetAttrCount(void) { return (parent?parent->GetParmCount():0) + Len(attrs); }
+
+public:
+    virtual int GetChildCount(void);
+
+public:
+    virtual Attribute *GetChildAttr(int i);
+
+public:
+    virtual int GetChildIndex(Attribute *a);
+
+public:
+    virtual int GetComputedCount(void);
+
+public:
+    virtual int GetOwnedCount(void);
+
+public:
+    virtual int GetBitsWidth(void);
+
+public:
+    virtual int GetBitsShift(Attribute *a);
+
+public:
+    virtual int GetComputedIndex(Attribute *a);
+
+public:
+    virtual int GetLazyCount(void);
+
+public:
+    virtual int GetLazyIndex(Attribute *a);
+
+public:
+    virtual int GetStoredCount(void);
+
+public:
+    virtual Attribute *GetStoredAttr(int i);
+
+public:
+    bool Is_A(Node *k) { return this == k || (parent && parent->Is_A(k)); }
 };
 
 //
-// -- The list of nodes
-//    -----------------
+// -- The list of nodes; once Semant is done it is in hierarchy preorder, which is the order of the node type tags,
+//    and declOrder keeps the order in which the nodes were declared, which is the order of the classes
+//    ----------------------------------------------------------------------------------------------------------
 typedef List<Node> NodeList;
 extern NodeList *nodes;
+extern NodeList *declOrder;
+
+
+//-------------------------------------------------------------------------------------------------------------------
+
+
+//
+// == The following structures are used to keep track of the rewrite rules.  A rule is a tree pattern over the
+//    node kinds, an optional guard, and the code that builds the replacement.  A pattern is either a node kind
+//    with patterns for its child slots (in the order of the child slots) or a wildcard.  Either may be bound to
+//    a name, which the guard and code use to reach the matched node.
+//    ==========================================================================================================
+
+class Pattern;
+
+//
+// -- A list of patterns
+//    ------------------
+typedef List<Pattern> PatList;
+
+
+//
+// -- This is a pattern within a rewrite rule.
+//    ----------------------------------------
+class Pattern {
+private:
+    std::string binding;
+
+public:
+    std::string &Get_Binding(void) { return binding; }
+
+private:
+    Symbol *kind;
+
+public:
+    Symbol *Get_Kind(void) { return kind; }
+
+private:
+    PatList *args;
+
+public:
+    void Set_Args(PatList *l) { args = l; }
+    Pattern *Get_Arg(int n) { PatList *t = Nth(args, n); return (t?t->elem():NULL); }
+    PatList *Get_Args(void) { return args; }
+
+protected:
+    Pattern(const std::string &b, Symbol *k) : binding(b), kind(k), args(NULL) {}
+
+public:
+    static Pattern *Factory(const std::string &b, Symbol *k) { return new Pattern(b, k); }
+
+public:
+    virtual ~Pattern(void) {}
+};
+
+
+//
+// -- This is a rewrite rule.
+//    -----------------------
+class Rewrite {
+private:
+    Pattern *pattern;
+
+public:
+    Pattern *Get_Pattern(void) { return pattern; }
+
+private:
+    std::string guard;
+
+public:
+    void Set_Guard(const std::string &g) { guard = g; }
+    std::string &Get_Guard(void) { return guard; }
+
+private:
+    std::string code;
+
+public:
+    std::string &Get_Code(void) { return code; }
+
+private:
+    int line;
+
+public:
+    int Get_Line(void) const { return line; }
+
+protected:
+    Rewrite(Pattern *p, const std::string &c, int l) : pattern(p), code(c), line(l) {}
+
+public:
+    static Rewrite *Factory(Pattern *p, const std::string &c, int l) { return new Rewrite(p, c, l); }
+
+public:
+    virtual ~Rewrite(void) {}
+};
+
+
+//
+// -- The list of rewrite rules, in priority order
+//    --------------------------------------------
+typedef List<Rewrite> RewriteList;
+extern RewriteList *rewrites;
+
+
+//-------------------------------------------------------------------------------------------------------------------
+
+
+//
+// == The following structures are used to keep track of the literal trees, which are built into the target as
+//    constant data.  The description of a tree is kept as written until Semant() parses it into LitNodes: a
+//    node kind with an argument for each of its stored attributes, where an argument for a child is another
+//    LitNode and any other argument is code (a LitNode without a kind).
+//    =========================================================================================================
+
+class LitNode;
+
+//
+// -- A list of literal tree nodes
+//    ----------------------------
+typedef List<LitNode> LitList;
+
+
+//
+// -- This is a node of a literal tree, or an argument given as code
+//    --------------------------------------------------------------
+class LitNode {
+private:
+    Symbol *kind;
+
+public:
+    Symbol *Get_Kind(void) { return kind; }
+
+private:
+    std::string code;
+
+public:
+    std::string &Get_Code(void) { return code; }
+
+private:
+    LitList *args;
+
+public:
+    void Set_Args(LitList *l) { args = l; }
+    LitList *Get_Args(void) { return args; }
+
+private:
+    int index;
+
+public:
+    void Set_Index(int i) { index = i; }
+    int Get_Index(void) const { return index; }
+
+protected:
+    LitNode(Symbol *k, const std::string &c) : kind(k), code(c), args(NULL), index(-1) {}
+
+public:
+    static LitNode *Factory(Symbol *k, const std::string &c) { return new LitNode(k, c); }
+
+public:
+    virtual ~LitNode(void) {}
+};
+
+
+//
+// -- This is a literal tree
+//    ----------------------
+class Literal {
+private:
+    std::string name;
+
+public:
+    std::string &Get_Name(void) { return name; }
+
+private:
+    Symbol *type;
+
+public:
+    Symbol *Get_Type(void) { return type; }
+
+private:
+    std::string code;
+
+public:
+    std::string &Get_Code(void) { return code; }
+
+private:
+    LitNode *tree;
+
+public:
+    void Set_Tree(LitNode *t) { tree = t; }
+    LitNode *Get_Tree(void) { return tree; }
+
+private:
+    int line;
+
+public:
+    int Get_Line(void) const { return line; }
+
+protected:
+    Literal(const std::string &n, Symbol *t, const std::string &c, int l) : name(n), type(t), code(c), tree(NULL),
+            line(l) {}
+
+public:
+    static Literal *Factory(const std::string &n, Symbol *t, const std::string &c, int l) {
+        return new Literal(n, t, c, l);
+    }
+
+public:
+    virtual ~Literal(void) {}
+};
+
+
+//
+// -- The list of literal trees
+//    -------------------------
+typedef List<Literal> LiteralList;
+extern LiteralList *literals;
 
 
 //-------------------------------------------------------------------------------------------------------------------
 
 extern std::string outputFile;
+std::string InputStamp(void);
@@ -31,18 +31,45 @@
 // ----------  -------  -------  ----  -----------------------------------------------------------------------------
 // 2016-03-28    N/A     v0.1    ADCL  second version of the ast language
 // 2016-10-18   #305     v0.1    ADCL  Remove extra "()" in an initializer and allow an empty initializer.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add GetChildCount() and GetRootNode() for the child slot tables.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --parallel command line option.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the semantic checks for the rewrite rules.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add computed attributes, which also need parent links.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --parents command line option.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --stats command line option.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --trace command line option.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add immutable nodes.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add owned attributes.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --variant command line option.
+// 2026-10-18    N/A    v0.1.1   ADCL  Put the nodes in hierarchy preorder so each subtree has a tag range.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add interned attributes and the built-in location type.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add bits(N) attributes.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add flattened node families.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --ids command line option.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add lazy attributes.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --index command line option.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add literal nodes and the semantic checks for the literal trees.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --dump command line option.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --digest command line option, which also needs parent links.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --clone command line option.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --final command line option and the devirtualization analysis.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the --shm command line option.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the input stamp, -MD, -MF and --force for an early exit when up to date.
+// 2026-10-18    N/A    v0.1.1   ADCL  Keep the declaration order of the nodes for the classes.
 //
 //===================================================================================================================
 
 #include "lists.hh"
 #include "ast-cc.hh"
+#include <cctype>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <fstream>
+#include <sys/stat.h>
 
 
-extern void cpp_Emit(void);
+extern bool cpp_Emit(void);
 
 
 //-------------------------------------------------------------------------------------------------------------------
@@ -56,7 +83,7 @@ int Node::GetParmCount(void)
     if (parent) rv = parent->GetParmCount();
 
     for (al = First(attrs); More(al); al = Next(al)) {
-        if (al->elem()->Get_Flags() & NOINIT) continue;
+        if (al->elem()->Get_Flags() & (NOINIT | COMPUTED | LAZY)) continue;
         else rv ++;
     }
 
@@ -64,14 +91,234 @@ int Node::GetParmCount(void)
 }
 
 
+//-------------------------------------------------------------------------------------------------------------------
+// Count the number of node-typed attributes (child slots), including those inherited
+//-------------------------------------------------------------------------------------------------------------------
+int Node::GetChildCount(void)
+{
+    AttrList *al;
+    int rv = 0;
+
+    if (parent) rv = parent->GetChildCount();
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (al->elem()->Is_Child()) rv ++;
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Get the attribute for child slot i, counting inherited child slots first; NULL if there is no such slot
+//-------------------------------------------------------------------------------------------------------------------
+Attribute *Node::GetChildAttr(int i)
+{
+    AttrList *al;
+    int base = (parent?parent->GetChildCount():0);
+
+    if (i < base) return parent->GetChildAttr(i);
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (!al->elem()->Is_Child()) continue;
+        if (i == base) return al->elem();
+        base ++;
+    }
+
+    return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Get the child slot index of one of this node's own attributes; -1 if it is not a child slot
+//-------------------------------------------------------------------------------------------------------------------
+int Node::GetChildIndex(Attribute *a)
+{
+    AttrList *al;
+    int rv = (parent?parent->GetChildCount():0);
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (!al->elem()->Is_Child()) continue;
+        if (al->elem() == a) return rv;
+        rv ++;
+    }
+
+    return -1;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Count the number of computed attributes, including those inherited
+//-------------------------------------------------------------------------------------------------------------------
+int Node::GetComputedCount(void)
+{
+    AttrList *al;
+    int rv = 0;
+
+    if (parent) rv = parent->GetComputedCount();
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (al->elem()->Get_Flags() & COMPUTED) rv ++;
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Count the number of owned attributes, including those inherited
+//-------------------------------------------------------------------------------------------------------------------
+int Node::GetOwnedCount(void)
+{
+    AttrList *al;
+    int rv = 0;
+
+    if (parent) rv = parent->GetOwnedCount();
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (al->elem()->Get_Flags() & OWNED) rv ++;
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Get the total width of this node's own bits(N) attributes, which are packed into one word
+//-------------------------------------------------------------------------------------------------------------------
+int Node::GetBitsWidth(void)
+{
+    AttrList *al;
+    int rv = 0;
+
+    for (al = First(attrs); More(al); al = Next(al)) rv += al->elem()->Get_Bits();
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Get the position of one of this node's own bits(N) attributes in its packed word; -1 if not packed
+//-------------------------------------------------------------------------------------------------------------------
+int Node::GetBitsShift(Attribute *a)
+{
+    AttrList *al;
+    int rv = 0;
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (al->elem() == a) return (a->Get_Bits() ? rv : -1);
+        rv += al->elem()->Get_Bits();
+    }
+
+    return -1;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Get the bit that tracks whether one of this node's own computed attributes is cached; -1 if not computed
+//-------------------------------------------------------------------------------------------------------------------
+int Node::GetComputedIndex(Attribute *a)
+{
+    AttrList *al;
+    int rv = (parent?parent->GetComputedCount():0);
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (!(al->elem()->Get_Flags() & COMPUTED)) continue;
+        if (al->elem() == a) return rv;
+        rv ++;
+    }
+
+    return -1;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Count this node's own lazy attributes, which are tracked with the bits of one word in the node
+//-------------------------------------------------------------------------------------------------------------------
+int Node::GetLazyCount(void)
+{
+    AttrList *al;
+    int rv = 0;
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (al->elem()->Get_Flags() & LAZY) rv ++;
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Get the bit that tracks whether one of this node's own lazy attributes has been evaluated; -1 if not lazy
+//-------------------------------------------------------------------------------------------------------------------
+int Node::GetLazyIndex(Attribute *a)
+{
+    AttrList *al;
+    int rv = 0;
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (!(al->elem()->Get_Flags() & LAZY)) continue;
+        if (al->elem() == a) return rv;
+        rv ++;
+    }
+
+    return -1;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Count the attributes stored in the node (those that are not static), including those inherited
+//-------------------------------------------------------------------------------------------------------------------
+int Node::GetStoredCount(void)
+{
+    AttrList *al;
+    int rv = 0;
+
+    if (parent) rv = parent->GetStoredCount();
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (!(al->elem()->Get_Flags() & STATIC)) rv ++;
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// Get stored attribute i, counting the inherited ones first; NULL if there is no such attribute
+//-------------------------------------------------------------------------------------------------------------------
+Attribute *Node::GetStoredAttr(int i)
+{
+    AttrList *al;
+    int base = (parent?parent->GetStoredCount():0);
+
+    if (i < base) return parent->GetStoredAttr(i);
+
+    for (al = First(attrs); More(al); al = Next(al)) {
+        if (al->elem()->Get_Flags() & STATIC) continue;
+        if (i == base) return al->elem();
+        base ++;
+    }
+
+    return NULL;
+}
+
+
 //
 // -- Initialize the global variables
 //    -------------------------------
 IncludeList *includes = NULL;
 SymTable *symtab = NULL;
 NodeList *nodes = NULL;
+NodeList *declOrder = NULL;
+RewriteList *rewrites = NULL;
+LiteralList *literals = NULL;
 char *endingCode = NULL;
 std::string outputFile = std::string("ast-nodes.hh");
+int options = OPT_NONE;
+static std::string inputHash;
+static bool verbose = false;
+static const char *generator = NULL;
 
 
 //-------------------------------------------------------------------------------------------------------------------
@@ -88,28 +335,563 @@ Symbol *AddTypeSymbol(const std::string &n)
 
 
 //-------------------------------------------------------------------------------------------------------------------
-// AddNodeSymbol(const std::string &) -- Create a NODE symbol as long as the name does not exist
+// AddNodeSymbol(const std::string &) -- Create a NODE symbol as long as the name does not exist
+//-------------------------------------------------------------------------------------------------------------------
+Symbol *AddNodeSymbol(const std::string &n)
+{
+    if (LookupSymbol(n) == false) {
+        Symbol *rv = Symbol::Factory(NODE, n);
+        symtab = Append(symtab, new SymTable(rv, NULL));
+        return rv;
+    } else return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// LookupSymbol(const std::string &) -- look for a symbol by name and return whether it exists
+//-------------------------------------------------------------------------------------------------------------------
+bool LookupSymbol(const std::string &n)
+{
+    SymTable *wrk;
+
+    for (wrk = First(symtab); More(wrk); wrk = Next(wrk)) {
+        Symbol *tmp = wrk->elem();
+        if (tmp->Get_Name() == n) return true;
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// GetSymbol(const std::string &) -- look for a symbol by name and return its structure
+//-------------------------------------------------------------------------------------------------------------------
+Symbol *GetSymbol(const std::string &n)
+{
+    SymTable *wrk;
+
+    for (wrk = First(symtab); More(wrk); wrk = Next(wrk)) {
+        Symbol *tmp = wrk->elem();
+        if (tmp->Get_Name() == n) return tmp;
+    }
+
+    return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// GetRootNode() -- return the Common node, which is always the first node defined and the root of all others
+//-------------------------------------------------------------------------------------------------------------------
+Node *GetRootNode(void)
+{
+    return (nodes?nodes->elem():NULL);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// GetNode(Symbol *) -- return the node for a NODE symbol
+//-------------------------------------------------------------------------------------------------------------------
+Node *GetNode(Symbol *s)
+{
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        if (wrk->elem()->Get_Name() == s) return wrk->elem();
+    }
+
+    return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// HasComputedAttrs() -- determine if any node has a computed attribute
+//-------------------------------------------------------------------------------------------------------------------
+bool HasComputedAttrs(void)
+{
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        if (wrk->elem()->GetComputedCount()) return true;
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// NeedParentLinks() -- determine if the nodes need to maintain links to their parents; computed attributes and
+//                      the --digest option need them to invalidate the cached values of the ancestors, and they
+//                      can be requested with the --parents option
+//-------------------------------------------------------------------------------------------------------------------
+bool NeedParentLinks(void)
+{
+    return (options & (OPT_PARENTS | OPT_DIGEST)) || HasComputedAttrs();
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// HasImmutableNodes() -- determine if any node is immutable
+//-------------------------------------------------------------------------------------------------------------------
+bool HasImmutableNodes(void)
+{
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        if (wrk->elem()->Get_Flags() & IMMUTABLE) return true;
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// HasOwnedAttrs() -- determine if any node has an owned attribute
+//-------------------------------------------------------------------------------------------------------------------
+bool HasOwnedAttrs(void)
+{
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        if (wrk->elem()->GetOwnedCount()) return true;
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// HasInternedAttrs() -- determine if any node has an interned attribute
+//-------------------------------------------------------------------------------------------------------------------
+bool HasInternedAttrs(void)
+{
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        for (AttrList *al = First(wrk->elem()->Get_Attrs()); More(al); al = Next(al)) {
+            if (al->elem()->Get_Flags() & INTERNED) return true;
+        }
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// HasBitsAttrs() -- determine if any node has a bits(N) attribute
+//-------------------------------------------------------------------------------------------------------------------
+bool HasBitsAttrs(void)
+{
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        if (wrk->elem()->GetBitsWidth()) return true;
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// HasFlatNodes() -- determine if any node is the root of a flattened family
+//-------------------------------------------------------------------------------------------------------------------
+bool HasFlatNodes(void)
+{
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        if (wrk->elem()->Get_Flags() & FLATTEN) return true;
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// HasLazyAttrs() -- determine if any node has a lazy attribute
+//-------------------------------------------------------------------------------------------------------------------
+bool HasLazyAttrs(void)
+{
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        if (wrk->elem()->GetLazyCount()) return true;
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// HasLiteralNodes() -- determine if any node can be built as a literal
+//-------------------------------------------------------------------------------------------------------------------
+bool HasLiteralNodes(void)
+{
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        if (wrk->elem()->Get_Flags() & LITERAL) return true;
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// IsLiteralBase() -- determine if a node is a base class of a literal node, so it needs a literal constructor too
+//-------------------------------------------------------------------------------------------------------------------
+bool IsLiteralBase(Node *n)
+{
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        Node *m = wrk->elem();
+
+        if (m != n && (m->Get_Flags() & LITERAL) && m->Is_A(n)) return true;
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// UsesLocation() -- determine if the built-in location type is used by any attribute or method
+//-------------------------------------------------------------------------------------------------------------------
+bool UsesLocation(void)
+{
+    Symbol *loc = GetSymbol(std::string("location"));
+    NodeList *wrk;
+
+    for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+        for (AttrList *al = First(wrk->elem()->Get_Attrs()); More(al); al = Next(al)) {
+            if (al->elem()->Get_Type() == loc) return true;
+        }
+
+        for (MethList *ml = First(wrk->elem()->Get_Meths()); More(ml); ml = Next(ml)) {
+            if (ml->elem()->Get_Type() == loc) return true;
+
+            for (ParmList *pl = First(ml->elem()->Get_Parms()); More(pl); pl = Next(pl)) {
+                if (pl->elem()->Get_Type() == loc) return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// SemantPattern() -- Check a rewrite pattern, collecting the names it binds
+//-------------------------------------------------------------------------------------------------------------------
+static bool SemantPattern(Rewrite *r, Pattern *p, List<std::string> **names)
+{
+    bool rv = true;
+
+    //
+    // -- each name may only be bound once in a rule
+    //    ------------------------------------------
+    if (p->Get_Binding() != "") {
+        for (List<std::string> *chk = First(*names); More(chk); chk = Next(chk)) {
+            if (*chk->elem() == p->Get_Binding()) {
+                fprintf(stderr, "Error: Name %s is bound more than once in the rewrite rule at line %d\n",
+                        p->Get_Binding().c_str(), r->Get_Line());
+                rv = false;
+            }
+        }
+
+        *names = Append(*names, new List<std::string>(&p->Get_Binding(), NULL));
+    }
+
+    if (!p->Get_Kind()) return rv;
+
+    //
+    // -- a kind must be a node, and it cannot have more patterns than child slots
+    //    ------------------------------------------------------------------------
+    Node *n = GetNode(p->Get_Kind());
+
+    if (!n) {
+        fprintf(stderr, "Error: %s is not a node in the rewrite rule at line %d\n",
+                p->Get_Kind()->Get_Name().c_str(), r->Get_Line());
+        return false;
+    }
+
+    if (Len(p->Get_Args()) > n->GetChildCount()) {
+        fprintf(stderr, "Error: %s has %d child slots but the rewrite rule at line %d matches %d\n",
+                p->Get_Kind()->Get_Name().c_str(), n->GetChildCount(), r->Get_Line(), Len(p->Get_Args()));
+        rv = false;
+    }
+
+    for (PatList *pl = First(p->Get_Args()); More(pl); pl = Next(pl)) {
+        if (!SemantPattern(r, pl->elem(), names)) rv = false;
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// LitSkipSpace() -- Skip the white space (and // comments) in a literal tree description
+//-------------------------------------------------------------------------------------------------------------------
+static void LitSkipSpace(const std::string &s, size_t &p)
+{
+    while (p < s.size()) {
+        if (isspace((unsigned char)s[p])) p ++;
+        else if (s.compare(p, 2, "//") == 0) { while (p < s.size() && s[p] != '\n') p ++; }
+        else break;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// LitParseName() -- Parse a name in a literal tree description; returns "" if there is none
+//-------------------------------------------------------------------------------------------------------------------
+static std::string LitParseName(const std::string &s, size_t &p)
+{
+    size_t start = p;
+
+    if (p < s.size() && (isalpha((unsigned char)s[p]) || s[p] == '_')) {
+        while (p < s.size() && (isalnum((unsigned char)s[p]) || s[p] == '_')) p ++;
+    }
+
+    return s.substr(start, p - start);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// LitParseCode() -- Parse an argument given as code, which runs to the next ',' or ')' that is not nested in
+//                   parentheses, brackets, braces or a string or character literal
+//-------------------------------------------------------------------------------------------------------------------
+static std::string LitParseCode(const std::string &s, size_t &p)
+{
+    size_t start = p;
+    int depth = 0;
+
+    while (p < s.size()) {
+        char c = s[p];
+
+        if (depth == 0 && (c == ',' || c == ')')) break;
+
+        if (c == '"' || c == '\'') {
+            for (p ++; p < s.size() && s[p] != c; p ++) if (s[p] == '\\') p ++;
+        } else if (c == '(' || c == '[' || c == '{') depth ++;
+        else if (c == ')' || c == ']' || c == '}') depth --;
+
+        p ++;
+    }
+
+    size_t end = p;
+    while (end > start && isspace((unsigned char)s[end - 1])) end --;
+
+    return s.substr(start, end - start);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// LitParseNode() -- Parse a node of a literal tree description: Kind(arg, ...), where an argument that starts with
+//                   a node name and a '(' is a nested node and any other argument is code; returns NULL on error
+//-------------------------------------------------------------------------------------------------------------------
+static LitNode *LitParseNode(Literal *l, const std::string &s, size_t &p)
+{
+    LitSkipSpace(s, p);
+
+    std::string name = LitParseName(s, p);
+    Symbol *k = (name == "" ? NULL : GetSymbol(name));
+
+    LitSkipSpace(s, p);
+
+    if (!k || k->Get_Kind() != NODE || p >= s.size() || s[p] != '(') {
+        fprintf(stderr, "Error: Expected a node kind and '(' in literal tree %s at line %d\n", l->Get_Name().c_str(),
+                l->Get_Line());
+        return NULL;
+    }
+
+    LitNode *rv = LitNode::Factory(k, "");
+    LitList *args = NULL;
+
+    p ++;
+    LitSkipSpace(s, p);
+
+    while (p < s.size() && s[p] != ')') {
+        size_t save = p;
+        std::string arg = LitParseName(s, p);
+        Symbol *sym = (arg == "" ? NULL : GetSymbol(arg));
+        LitNode *a;
+
+        LitSkipSpace(s, p);
+
+        if (sym && sym->Get_Kind() == NODE && p < s.size() && s[p] == '(') {
+            p = save;
+            a = LitParseNode(l, s, p);
+            if (!a) return NULL;
+        } else {
+            p = save;
+            a = LitNode::Factory(NULL, LitParseCode(s, p));
+        }
+
+        args = Append(args, new LitList(a, NULL));
+
+        LitSkipSpace(s, p);
+        if (p < s.size() && s[p] == ',') { p ++; LitSkipSpace(s, p); }
+        else break;
+    }
+
+    if (p >= s.size() || s[p] != ')') {
+        fprintf(stderr, "Error: Expected ',' or ')' in literal tree %s at line %d\n", l->Get_Name().c_str(),
+                l->Get_Line());
+        return NULL;
+    }
+
+    p ++;
+    rv->Set_Args(args);
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// SemantLitNode() -- Check a node of a literal tree against the node it builds, and number the nodes in postorder
+//                    (which is the order they are laid out in, children first)
+//-------------------------------------------------------------------------------------------------------------------
+static bool SemantLitNode(Literal *l, LitNode *ln, int *index)
+{
+    Node *n = GetNode(ln->Get_Kind());
+    bool rv = true;
+    int i = 0;
+
+    if (!(n->Get_Flags() & LITERAL)) {
+        fprintf(stderr, "Error: %s is not a literal node in literal tree %s at line %d\n",
+                ln->Get_Kind()->Get_Name().c_str(), l->Get_Name().c_str(), l->Get_Line());
+        return false;
+    }
+
+    if (Len(ln->Get_Args()) != n->GetStoredCount()) {
+        fprintf(stderr, "Error: %s has %d attributes but literal tree %s at line %d gives it %d\n",
+                ln->Get_Kind()->Get_Name().c_str(), n->GetStoredCount(), l->Get_Name().c_str(), l->Get_Line(),
+                Len(ln->Get_Args()));
+        return false;
+    }
+
+    for (LitList *al = First(ln->Get_Args()); More(al); al = Next(al), i ++) {
+        Attribute *a = n->GetStoredAttr(i);
+        LitNode *arg = al->elem();
+
+        if (!arg->Get_Kind()) {
+            bool null = (arg->Get_Code() == "NULL" || arg->Get_Code() == "nullptr");
+
+            if (a->Get_Type()->Get_Kind() == NODE && !null) {
+                fprintf(stderr, "Error: Attribute %s of %s must be a node or NULL in literal tree %s at line %d\n",
+                        a->Get_Name().c_str(), ln->Get_Kind()->Get_Name().c_str(), l->Get_Name().c_str(),
+                        l->Get_Line());
+                rv = false;
+            } else if (arg->Get_Code() == "") {
+                fprintf(stderr, "Error: Attribute %s of %s is empty in literal tree %s at line %d\n",
+                        a->Get_Name().c_str(), ln->Get_Kind()->Get_Name().c_str(), l->Get_Name().c_str(),
+                        l->Get_Line());
+                rv = false;
+            }
+
+            continue;
+        }
+
+        if (a->Get_Type()->Get_Kind() != NODE || !GetNode(arg->Get_Kind())->Is_A(GetNode(a->Get_Type()))) {
+            fprintf(stderr, "Error: Attribute %s of %s cannot be a %s in literal tree %s at line %d\n",
+                    a->Get_Name().c_str(), ln->Get_Kind()->Get_Name().c_str(), arg->Get_Kind()->Get_Name().c_str(),
+                    l->Get_Name().c_str(), l->Get_Line());
+            rv = false;
+            continue;
+        }
+
+        if (!SemantLitNode(l, arg, index)) rv = false;
+    }
+
+    ln->Set_Index((*index) ++);
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// SemantLiteral() -- Parse the description of a literal tree and check it
+//-------------------------------------------------------------------------------------------------------------------
+static bool SemantLiteral(Literal *l)
+{
+    std::string &s = l->Get_Code();
+    size_t p = 1;                   // -- skip the opening brace
+    int index = 0;
+
+    LitNode *root = LitParseNode(l, s, p);
+    if (!root) return false;
+
+    LitSkipSpace(s, p);
+
+    if (p + 1 != s.size()) {
+        fprintf(stderr, "Error: Literal tree %s at line %d has more than one root\n", l->Get_Name().c_str(),
+                l->Get_Line());
+        return false;
+    }
+
+    l->Set_Tree(root);
+    if (!SemantLitNode(l, root, &index)) return false;
+
+    if (!GetNode(root->Get_Kind())->Is_A(GetNode(l->Get_Type()))) {
+        fprintf(stderr, "Error: The root of literal tree %s at line %d is not a %s\n", l->Get_Name().c_str(),
+                l->Get_Line(), l->Get_Type()->Get_Name().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// OrderNodes() -- Append a node and the nodes derived from it to a list in preorder, keeping the order in which
+//                 they were defined among the siblings
+//-------------------------------------------------------------------------------------------------------------------
+static NodeList *OrderNodes(NodeList *ordered, Node *node)
+{
+    ordered = Append(ordered, new NodeList(node, NULL));
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        if (nl->elem()->Get_Parent() == node) ordered = OrderNodes(ordered, nl->elem());
+    }
+
+    return ordered;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// SameSignature() -- Are 2 methods the same name with the same parameter types (the return type is not compared)
+//-------------------------------------------------------------------------------------------------------------------
+static bool SameSignature(Method *m, Method *chk)
+{
+    if (m->Get_Name() != chk->Get_Name()) return false;
+    if (Len(m->Get_Parms()) != Len(chk->Get_Parms())) return false;
+
+    for (int i = 0; i < Len(m->Get_Parms()); i ++) {
+        if (m->Get_Parm(i)->Get_Type() != chk->Get_Parm(i)->Get_Type()) return false;
+    }
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// DeclaresMethod() -- Does a node declare a method with the same signature as m
 //-------------------------------------------------------------------------------------------------------------------
-Symbol *AddNodeSymbol(const std::string &n)
+static bool DeclaresMethod(Node *n, Method *m)
 {
-    if (LookupSymbol(n) == false) {
-        Symbol *rv = Symbol::Factory(NODE, n);
-        symtab = Append(symtab, new SymTable(rv, NULL));
-        return rv;
-    } else return NULL;
+    for (MethList *ml = First(n->Get_Meths()); More(ml); ml = Next(ml)) {
+        if (!(ml->elem()->Get_Flags() & STATIC) && SameSignature(ml->elem(), m)) return true;
+    }
+
+    return false;
 }
 
 
 //-------------------------------------------------------------------------------------------------------------------
-// LookupSymbol(const std::string &) -- look for a symbol by name and return whether it exists
+// IsDerivedFrom() -- Is n derived (directly or not) from base
 //-------------------------------------------------------------------------------------------------------------------
-bool LookupSymbol(const std::string &n)
+static bool IsDerivedFrom(Node *n, Node *base)
 {
-    SymTable *wrk;
-
-    for (wrk = First(symtab); More(wrk); wrk = Next(wrk)) {
-        Symbol *tmp = wrk->elem();
-        if (tmp->Get_Name() == n) return true;
+    for (Node *p = n->Get_Parent(); p; p = p->Get_Parent()) {
+        if (p == base) return true;
     }
 
     return false;
@@ -117,18 +899,72 @@ bool LookupSymbol(const std::string &n)
 
 
 //-------------------------------------------------------------------------------------------------------------------
-// GetSymbol(const std::string &) -- look for a symbol by name and return its structure
+// Devirtualize() -- With --final, the nodes in the source are the whole hierarchy, so mark the leaf nodes final,
+//                   mark final the methods that override and are not overridden again, and emit the methods that
+//                   neither override nor are overridden without virtual.  With --verbose, report the vtable
+//                   entries dropped.
+//
+// Each method emitted without virtual drops its entry from the vtable of its node and of every node derived from
+// it.  An abstract method keeps its entry, since it is called through the node that declares it.
 //-------------------------------------------------------------------------------------------------------------------
-Symbol *GetSymbol(const std::string &n)
+static void Devirtualize(void)
 {
-    SymTable *wrk;
+    int leaves = 0;
+    int finals = 0;
+    int methods = 0;
+    int entries = 0;
 
-    for (wrk = First(symtab); More(wrk); wrk = Next(wrk)) {
-        Symbol *tmp = wrk->elem();
-        if (tmp->Get_Name() == n) return tmp;
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        bool leaf = true;
+        int derived = 0;
+
+        for (NodeList *chk = First(nodes); More(chk); chk = Next(chk)) {
+            if (chk->elem()->Get_Parent() == n) leaf = false;
+            if (IsDerivedFrom(chk->elem(), n)) derived ++;
+        }
+
+        if (leaf && !(n->Get_Flags() & ABSTRACT)) {
+            n->Set_Flag(FINAL);
+            leaves ++;
+        }
+
+        for (MethList *ml = First(n->Get_Meths()); More(ml); ml = Next(ml)) {
+            Method *m = ml->elem();
+            bool overrides = false;
+            bool overridden = false;
+
+            if (m->Get_Flags() & (STATIC | ABSTRACT)) continue;
+
+            for (Node *p = n->Get_Parent(); p; p = p->Get_Parent()) {
+                if (DeclaresMethod(p, m)) overrides = true;
+            }
+
+            for (NodeList *chk = First(nodes); More(chk); chk = Next(chk)) {
+                if (IsDerivedFrom(chk->elem(), n) && DeclaresMethod(chk->elem(), m)) overridden = true;
+            }
+
+            if (overrides && !overridden) {
+                m->Set_Flag(FINAL);
+                finals ++;
+            } else if (!overrides && !overridden) {
+                m->Set_Flag(NONVIRTUAL);
+                methods ++;
+                entries += derived + 1;
+
+                if (verbose) {
+                    fprintf(stderr, "Note: %s::%s() is not virtual, which drops %d vtable %s\n",
+                            n->Get_Name()->Get_Name().c_str(), m->Get_Name().c_str(), derived + 1,
+                            derived ? "entries" : "entry");
+                }
+            }
+        }
     }
 
-    return NULL;
+    if (verbose) {
+        fprintf(stderr, "Note: %d leaf node(s) and %d override(s) are final; %d method(s) are not virtual, which "
+                "drops %d vtable entries\n", leaves, finals, methods, entries);
+    }
 }
 
 
@@ -156,6 +992,87 @@ bool Semant(void)
         }
     }
 
+    //
+    // -- An immutable declaration in the source makes every node immutable.  Immutable nodes can be shared by
+    //    any number of trees (and threads), so they cannot have a single parent or cache anything that changes.
+    //    Their lazy attributes are still fine, since they are evaluated at most once (under a once-flag).
+    //    -----------------------------------------------------------------------------------------------------
+    if (options & OPT_IMMUTABLE) {
+        for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) nl->elem()->Set_Flag(IMMUTABLE);
+    }
+
+    if (HasImmutableNodes() && NeedParentLinks()) {
+        fprintf(stderr, "Error: Immutable nodes cannot be used with parent links (--parents, --digest or computed "
+                "attributes)\n");
+        rv = false;
+    }
+
+    //
+    // -- An immutable node is never copied: it is shared, and the with_ functions already copy only the path to a
+    //    change.  A clone also sets the no-init attributes after the constructor, which immutable nodes cannot.
+    //    -------------------------------------------------------------------------------------------------------
+    if (HasImmutableNodes() && (options & OPT_CLONE)) {
+        fprintf(stderr, "Error: Immutable nodes cannot be used with --clone; share them or use their with_ "
+                "functions\n");
+        rv = false;
+    }
+
+    //
+    // -- The --variant nodes are values without a vtable or a common base class, so none of the support code
+    //    that works on the tree through the root node is available.
+    //    ---------------------------------------------------------------------------------------------------
+    if (options & OPT_VARIANT) {
+        if (options & (OPT_PARALLEL | OPT_PARENTS | OPT_STATS | OPT_TRACE | OPT_IDS | OPT_INDEX | OPT_DUMP |
+                OPT_DIGEST | OPT_CLONE | OPT_FINAL)) {
+            fprintf(stderr, "Error: --variant cannot be used with --parallel, --parents, --stats, --trace, --ids, "
+                    "--index, --dump, --digest, --clone or --final\n");
+            rv = false;
+        }
+
+        if (HasImmutableNodes() || HasComputedAttrs() || HasOwnedAttrs() || HasInternedAttrs() || HasBitsAttrs() ||
+                HasLazyAttrs()) {
+            fprintf(stderr, "Error: --variant cannot be used with immutable nodes or computed, owned, interned, "
+                    "bits or lazy attributes\n");
+            rv = false;
+        }
+
+        if (HasFlatNodes()) {
+            fprintf(stderr, "Error: --variant cannot be used with flattened nodes\n");
+            rv = false;
+        }
+
+        if (rewrites) {
+            fprintf(stderr, "Error: --variant cannot be used with rewrite rules\n");
+            rv = false;
+        }
+
+        if (HasLiteralNodes() || literals) {
+            fprintf(stderr, "Error: --variant cannot be used with literal nodes or literal trees\n");
+            rv = false;
+        }
+    }
+
+    //
+    // -- A node with a vtable cannot be read in another process, so the shared memory segments hold the --variant
+    //    nodes only
+    //    --------------------------------------------------------------------------------------------------------
+    if ((options & OPT_SHM) && !(options & OPT_VARIANT)) {
+        fprintf(stderr, "Error: --shm can only be used with --variant, since a node with a vtable cannot be shared "
+                "between processes\n");
+        rv = false;
+    }
+
+    //
+    // -- A literal node is built by a constexpr constructor, so nothing in it can be set up at run time: there is
+    //    no parent link, node id, cache or intern table entry to fill in.  Its children are not owned, since a
+    //    literal tree is never deleted.
+    //    -------------------------------------------------------------------------------------------------------
+    if (HasLiteralNodes() && (NeedParentLinks() || (options & OPT_IDS))) {
+        fprintf(stderr, "Error: Literal nodes cannot be used with parent links (--parents, --digest or computed "
+                "attributes) or --ids\n");
+        rv = false;
+    }
+
     //
     // -- Next we will loop through the classes and start checking them.  First we set up the loop on the
     //    Nodes.
@@ -221,6 +1138,112 @@ bool Semant(void)
                         a->Get_Name().c_str(), n->Get_Name()->Get_Name().c_str());
                 rv = false;
             }
+
+            if ((f & COMPUTED) && (f & STATIC)) {
+                fprintf(stderr, "Error: Cannot specify STATIC on computed attribute %s in class %s\n",
+                        a->Get_Name().c_str(), n->Get_Name()->Get_Name().c_str());
+                rv = false;
+            }
+
+            if ((f & LAZY) && (f & (STATIC | NOINLINES | INTERNED | BITS))) {
+                fprintf(stderr, "Error: LAZY attribute %s in class %s cannot be static, no-inlines, interned or bits\n",
+                        a->Get_Name().c_str(), n->Get_Name()->Get_Name().c_str());
+                rv = false;
+            }
+
+            if ((f & OWNED) && !a->Is_Child()) {
+                fprintf(stderr, "Error: OWNED attribute %s in class %s must be a node that is not static, computed or "
+                        "lazy\n",
+                        a->Get_Name().c_str(), n->Get_Name()->Get_Name().c_str());
+                rv = false;
+            }
+
+            if ((f & BITS) && (a->Get_Bits() < 1 || a->Get_Bits() > 64)) {
+                fprintf(stderr, "Error: The width of BITS attribute %s in class %s must be from 1 to 64\n",
+                        a->Get_Name().c_str(), n->Get_Name()->Get_Name().c_str());
+                rv = false;
+            }
+
+            if ((f & BITS) && (a->Get_Type()->Get_Kind() == NODE || (f & (STATIC | COMPUTED | INTERNED | NOINLINES)))) {
+                fprintf(stderr, "Error: BITS attribute %s in class %s must be a type that is not static, computed, "
+                        "interned or no-inlines\n", a->Get_Name().c_str(), n->Get_Name()->Get_Name().c_str());
+                rv = false;
+            }
+
+            if ((f & INTERNED) && (a->Get_Type()->Get_Kind() == NODE || (f & (STATIC | COMPUTED)))) {
+                fprintf(stderr, "Error: INTERNED attribute %s in class %s must be a type that is not static or "
+                        "computed\n", a->Get_Name().c_str(), n->Get_Name()->Get_Name().c_str());
+                rv = false;
+            }
+        }
+
+        //
+        // -- an immutable node may be shared by several parents, so none of them can own its children
+        //    -----------------------------------------------------------------------------------------
+        if ((n->Get_Flags() & IMMUTABLE) && n->GetOwnedCount()) {
+            fprintf(stderr, "Error: Immutable class %s cannot have OWNED attributes since its children are shared\n",
+                    n->Get_Name()->Get_Name().c_str());
+            rv = false;
+        }
+
+        if (n->GetBitsWidth() > 64) {
+            fprintf(stderr, "Error: The BITS attributes of class %s do not fit in 64 bits\n",
+                    n->Get_Name()->Get_Name().c_str());
+            rv = false;
+        }
+
+        if (n->Get_Flags() & FLATTEN) {
+            bool concrete = false;
+
+            for (NodeList *chk = First(nodes); More(chk); chk = Next(chk)) {
+                if (chk->elem()->Is_A(n) && !(chk->elem()->Get_Flags() & ABSTRACT)) concrete = true;
+            }
+
+            if (!concrete) {
+                fprintf(stderr, "Error: Flattened class %s has no concrete classes to flatten\n",
+                        n->Get_Name()->Get_Name().c_str());
+                rv = false;
+            }
+        }
+
+        if (n->Get_Flags() & LITERAL) {
+            if (n->Get_Flags() & ABSTRACT) {
+                fprintf(stderr, "Error: Literal class %s cannot be abstract\n", n->Get_Name()->Get_Name().c_str());
+                rv = false;
+            }
+
+            for (Node *b = n; b; b = b->Get_Parent()) {
+                for (AttrList *al = First(b->Get_Attrs()); More(al); al = Next(al)) {
+                    if (al->elem()->Get_Flags() & (COMPUTED | LAZY | INTERNED | OWNED)) {
+                        fprintf(stderr, "Error: Literal class %s cannot have computed, lazy, interned or owned "
+                                "attribute %s\n", n->Get_Name()->Get_Name().c_str(), al->elem()->Get_Name().c_str());
+                        rv = false;
+                    }
+                }
+            }
+        }
+
+        if (n->GetLazyCount() > 32) {
+            fprintf(stderr, "Error: Class %s has more than 32 lazy attributes\n", n->Get_Name()->Get_Name().c_str());
+            rv = false;
+        }
+
+        //
+        // -- the cached computed attributes are tracked with the bits of a single word in the root node
+        //    ------------------------------------------------------------------------------------------
+        if (n->GetComputedCount() > 32) {
+            fprintf(stderr, "Error: Class %s has more than 32 computed attributes (including those inherited)\n",
+                    n->Get_Name()->Get_Name().c_str());
+            rv = false;
+        }
+
+        //
+        // -- The cached digest takes the last bit of the word that tracks the cached computed attributes
+        //    -------------------------------------------------------------------------------------------
+        if ((options & OPT_DIGEST) && n->GetComputedCount() > 31) {
+            fprintf(stderr, "Error: Class %s has more than 31 computed attributes (including those inherited), "
+                    "which is the limit with --digest\n", n->Get_Name()->Get_Name().c_str());
+            rv = false;
         }
 
         //
@@ -284,10 +1307,168 @@ bool Semant(void)
         }
     }
 
+    //
+    // -- Finally, check the rewrite rules.  The root of each rule must be a node kind (so the rule can be
+    //    dispatched on the node type) and the patterns must fit the nodes they name.
+    //    ------------------------------------------------------------------------------------------------
+    for (RewriteList *rl = First(rewrites); More(rl); rl = Next(rl)) {
+        Rewrite *r = rl->elem();
+        List<std::string> *names = NULL;
+
+        if (!r->Get_Pattern()->Get_Kind()) {
+            fprintf(stderr, "Error: The rewrite rule at line %d must match a node kind at its root\n", r->Get_Line());
+            rv = false;
+            continue;
+        }
+
+        if (!SemantPattern(r, r->Get_Pattern(), &names)) rv = false;
+    }
+
+    //
+    // -- And the literal trees, which are parsed here now that all the nodes are known
+    //    -----------------------------------------------------------------------------
+    for (LiteralList *ll = First(literals); More(ll); ll = Next(ll)) {
+        for (LiteralList *chk = Next(ll); More(chk); chk = Next(chk)) {
+            if (ll->elem()->Get_Name() == chk->elem()->Get_Name()) {
+                fprintf(stderr, "Error: Literal tree %s is defined more than once\n", ll->elem()->Get_Name().c_str());
+                rv = false;
+            }
+        }
+
+        if (!SemantLiteral(ll->elem())) rv = false;
+    }
+
+    //
+    // -- Last, put the nodes in preorder of the hierarchy.  The node type tags are numbered in this order, so
+    //    the concrete nodes derived from any node have a range of consecutive tags.  The classes are still
+    //    emitted in the order they were declared, since a method of one may need another declared before it.
+    //    ---------------------------------------------------------------------------------------------------
+    declOrder = nodes;
+    nodes = OrderNodes(NULL, GetRootNode());
+
+    if (rv && (options & OPT_FINAL)) Devirtualize();
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// HashBytes() -- Add bytes to an FNV-1a hash
+//-------------------------------------------------------------------------------------------------------------------
+static void HashBytes(unsigned long long &h, const char *p, size_t n)
+{
+    for (size_t i = 0; i < n; i ++) {
+        h ^= (unsigned char)p[i];
+        h *= 0x100000001b3ull;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// HashInput() -- Hash everything the output depends on: the ast-cc version and the size and time of the ast-cc
+//                program itself (so a rebuilt ast-cc of the same version runs again), the options, the output name,
+//                and the name and contents of the source file; "" if the source cannot be read
+//-------------------------------------------------------------------------------------------------------------------
+static std::string HashInput(const char *name)
+{
+    unsigned long long h = 0xcbf29ce484222325ull;
+    char buf[4096];
+    size_t len;
+    struct stat st;
+    FILE *fp = fopen(name, "rb");
+
+    if (!fp) return "";
+
+    snprintf(buf, sizeof(buf), "%d", options);
+
+    HashBytes(h, AST_CC_VERSION, strlen(AST_CC_VERSION) + 1);
+    HashBytes(h, buf, strlen(buf) + 1);
+
+    if (stat("/proc/self/exe", &st) == 0 || (generator && stat(generator, &st) == 0)) {
+        snprintf(buf, sizeof(buf), "%lld:%lld", (long long)st.st_size, (long long)st.st_mtime);
+        HashBytes(h, buf, strlen(buf) + 1);
+    }
+
+    HashBytes(h, outputFile.c_str(), outputFile.size() + 1);
+    HashBytes(h, name, strlen(name) + 1);
+
+    while ((len = fread(buf, 1, sizeof(buf), fp)) > 0) HashBytes(h, buf, len);
+
+    fclose(fp);
+
+    snprintf(buf, sizeof(buf), "%016llx", h);
+    return std::string(buf);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// InputStamp() -- The line cpp_EmitHeader() puts in the output, which names the version and the input hash
+//-------------------------------------------------------------------------------------------------------------------
+std::string InputStamp(void)
+{
+    return std::string("// ast-cc v") + AST_CC_VERSION + ", input hash " + inputHash;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// IsUpToDate() -- Does the output already carry the stamp of these inputs.  The stamp is in the first lines of the
+//                 file and is also its last line, so an output that was cut short is made again.
+//-------------------------------------------------------------------------------------------------------------------
+static bool IsUpToDate(void)
+{
+    std::ifstream is(outputFile.c_str(), std::ios::binary);
+    std::string stamp = InputStamp();
+    std::string line;
+    bool found = false;
+
+    for (int i = 0; i < 16 && !found && std::getline(is, line); i ++) {
+        if (line == stamp) found = true;
+    }
+
+    if (!found) return false;
+
+    line.assign(stamp.size() + 1, ' ');
+    is.clear();
+    is.seekg(-(std::streamoff)line.size(), std::ios::end);
+    is.read(&line[0], line.size());
+
+    return is.good() && line == stamp + "\n";
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// DepName() -- Escape a file name for a make rule
+//-------------------------------------------------------------------------------------------------------------------
+static std::string DepName(const std::string &n)
+{
+    std::string rv;
+
+    for (size_t i = 0; i < n.size(); i ++) {
+        if (n[i] == ' ' || n[i] == '#') rv += '\\';
+        else if (n[i] == '$') rv += '$';
+        rv += n[i];
+    }
+
     return rv;
 }
 
 
+//-------------------------------------------------------------------------------------------------------------------
+// WriteDepFile() -- Write a make rule for the output that depends on the source file, with an empty rule for the
+//                   source so that make does not stop if it is removed (as with gcc -MD -MP)
+//-------------------------------------------------------------------------------------------------------------------
+static bool WriteDepFile(const std::string &depFile, const char *name)
+{
+    std::ofstream os(depFile.c_str());
+
+    os << DepName(outputFile) << ": " << DepName(name) << std::endl << std::endl;
+    os << DepName(name) << ":" << std::endl;
+
+    os.close();
+    return !os.fail();
+}
+
+
 //-------------------------------------------------------------------------------------------------------------------
 // main() -- main entry point
 //-------------------------------------------------------------------------------------------------------------------
@@ -300,8 +1481,12 @@ int main(int argc, char *argv[])
     extern int yyparse(void);
 
     char *outfile = NULL;
+    std::string depFile;
+    bool depend = false;
+    bool force = false;
 
     yydebug = 0;
+    generator = argv[0];
 
     //
     // -- Initialize the compiler symbol table and Common node
@@ -309,6 +1494,7 @@ int main(int argc, char *argv[])
     nodes = Append(nodes, new NodeList(Node::Factory(NULL, AddNodeSymbol(std::string("Common"))), NULL));
     nodes->elem()->Set_Flag(ABSTRACT);
     AddTypeSymbol(std::string("void"));
+    AddTypeSymbol(std::string("location"));
 
     //
     // -- parse the files
@@ -320,9 +1506,115 @@ int main(int argc, char *argv[])
             continue;
         }
 
+        if (strcmp(argv[i], "--parallel") == 0) {
+            options |= OPT_PARALLEL;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--parents") == 0) {
+            options |= OPT_PARENTS;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--stats") == 0) {
+            options |= OPT_STATS;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--trace") == 0) {
+            options |= OPT_TRACE;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--variant") == 0) {
+            options |= OPT_VARIANT;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--ids") == 0) {
+            options |= OPT_IDS;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--index") == 0) {
+            options |= OPT_INDEX;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--dump") == 0) {
+            options |= OPT_DUMP;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--digest") == 0) {
+            options |= OPT_DIGEST;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--clone") == 0) {
+            options |= OPT_CLONE;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--final") == 0) {
+            options |= OPT_FINAL;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--shm") == 0) {
+            options |= OPT_SHM;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "-MD") == 0) {
+            depend = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "-MF") == 0 && i + 1 < argc) {
+            depFile = std::string(argv[++i]);
+            depend = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--force") == 0) {
+            force = true;
+            continue;
+        }
+
         if (openBuffer(argv[i])) {
             curr_file = argv[i];
 
+            //
+            // -- The dependencies are written first, so they are there even when there is nothing to do.  Then, if
+            //    the output was made from the same inputs, it is left alone (its time stamp too) without parsing.
+            //    ----------------------------------------------------------------------------------------------
+            if (depend) {
+                if (depFile.empty()) {
+                    size_t dot = outputFile.find_last_of('.');
+
+                    if (dot == std::string::npos || dot < outputFile.find_last_of('/') + 1) depFile = outputFile + ".d";
+                    else depFile = outputFile.substr(0, dot) + ".d";
+                }
+
+                if (!WriteDepFile(depFile, curr_file)) {
+                    fprintf(stderr, "Error: Unable to write the dependency file %s\n", depFile.c_str());
+                    return 1;
+                }
+            }
+
+            inputHash = HashInput(curr_file);
+
+            if (!force && !inputHash.empty() && IsUpToDate()) {
+                std::cout << "Up to date!" << std::endl;
+                return 0;
+            }
+
             if (yyparse()) std::cerr << "ERROR parsing the ast source" << std::endl;
             break;
         }
@@ -331,7 +1623,7 @@ int main(int argc, char *argv[])
     if (parse_error) return 1;
     if (!Semant()) return 1;
 
-    cpp_Emit();
+    if (!cpp_Emit()) return 1;
 
     std::cout << "Done!" << std::endl;
 
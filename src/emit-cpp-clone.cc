@@ -0,0 +1,358 @@
+//===================================================================================================================
+// emit-cpp-clone.cc -- This file is responsible for emitting the CPP clones of the nodes and subtrees
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// With the --clone option, every node gets Clone(), which copies the subtree below it, and ASTClonePath() copies
+// only the nodes on the path from the top of a tree down to one node, sharing all the other subtrees with the
+// original.  The copy of a node is built by its constructor from the attributes its Factory() function takes,
+// and then its no-init attributes are copied over; its computed and lazy attributes are evaluated again when
+// they are asked for.  So the clones follow the attributes in the source and never go stale.
+//
+// The memory for each copy comes from alloc(size), which can be any function or object that returns memory
+// aligned for any node: an arena, a pool or the heap (ASTHeap, the default).  The clones keep their own explicit
+// stacks, so a subtree of any depth can be copied.
+//
+// An owned child is always copied, never shared, since each tree deletes its owned children.  A shared subtree
+// keeps its parent link to the original only, so a change made in it invalidates the computed attributes and the
+// digests cached in the original but not those cached in the copy.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+// 2026-10-18    N/A    v0.1.1   ADCL  Copy the owned children rather than share them
+// 2026-10-18    N/A    v0.1.1   ADCL  Keep Make() warning-free when no node has children
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+
+extern std::string cpp_BitsWord(Node *node);
+extern void cpp_DumpAttrs(Node *node, std::vector<Attribute *> &parms, std::vector<Node *> &owners, size_t &kids,
+        size_t &vals);
+extern void cpp_EmitDumpValue(std::ofstream &os, Node *owner, Attribute *a);
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_CloneReadsNode() -- Determine if the copy of a node reads anything from the original besides the children
+//-------------------------------------------------------------------------------------------------------------------
+static bool cpp_CloneReadsNode(Node *node)
+{
+    for ( ; node; node = node->Get_Parent()) {
+        if (node->GetBitsWidth()) return true;
+
+        for (AttrList *al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+            Attribute *a = al->elem();
+
+            if (a->Get_Flags() & (STATIC | COMPUTED | LAZY)) continue;
+            if (!a->Is_Child() && a->Get_Type()->Get_Kind() != NODE) return true;
+        }
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitCloneRest() -- Emit the copies of the attributes the constructor does not take, starting with those
+//                        inherited; returns whether a child was among them
+//-------------------------------------------------------------------------------------------------------------------
+static bool cpp_EmitCloneRest(std::ofstream &os, Node *node)
+{
+    if (!node) return false;
+
+    bool rv = cpp_EmitCloneRest(os, node->Get_Parent());
+
+    if (node->GetBitsWidth()) {
+        os << "\t\t\ty->" << cpp_BitsWord(node) << " = x->" << cpp_BitsWord(node) << ";" << std::endl;
+    }
+
+    for (AttrList *al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        Attribute *a = al->elem();
+
+        if (!(a->Get_Flags() & NOINIT) || (a->Get_Flags() & (STATIC | COMPUTED | LAZY)) || a->Get_Bits()) continue;
+
+        if (a->Is_Child()) {
+            os << "\t\t\ty->" << a->Get_Name() << " = static_cast<" << a->Get_Type()->Get_Name() << " *>(kids["
+                    << node->GetChildIndex(a) << "]);" << std::endl;
+            rv = true;
+        } else os << "\t\t\ty->" << a->Get_Name() << " = x->" << a->Get_Name() << ";" << std::endl;
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitCloneMake() -- Emit the copy of one node, given the children for the copy in child slot order
+//
+// When there are parent links, the constructor adopts all the children it is given; the ones that are shared with
+// the original are given back to it, so the original tree is left as it was.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitCloneMake(std::ofstream &os)
+{
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Copy the node n, with the children kids (in child slot order)" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\ttemplate <class A> static " << root << " *Make(const " << root << " *n, A &alloc, " << root
+            << " *const *kids) {" << std::endl;
+    os << "\t\t(void)kids;" << std::endl;                   // -- unused when no node has children
+    os << "\t\t" << root << " *rv = NULL;" << std::endl << std::endl;
+    os << "\t\tswitch (n->_tag) {" << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> parms;
+        std::vector<Node *> owners;
+        size_t kids = 0, vals = 0;
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+
+        cpp_DumpAttrs(n, parms, owners, kids, vals);
+
+        std::string name = n->Get_Name()->Get_Name();
+
+        os << "\t\tcase NODE_TYPE_" << name << ": {" << std::endl;
+        if (cpp_CloneReadsNode(n)) {
+            os << "\t\t\tconst " << name << " *x = static_cast<const " << name << " *>(n);" << std::endl;
+        }
+
+        os << "\t\t\t" << name << " *y = new (alloc(sizeof(" << name << "))) " << name << "(";
+
+        for (size_t i = 0; i < parms.size(); i ++) {
+            if (i) os << ", ";
+
+            if (parms[i]->Get_Type()->Get_Kind() == NODE) {
+                os << "static_cast<" << parms[i]->Get_Type()->Get_Name() << " *>(kids["
+                        << owners[i]->GetChildIndex(parms[i]) << "])";
+            } else cpp_EmitDumpValue(os, owners[i], parms[i]);
+        }
+
+        os << ");" << std::endl << std::endl;
+
+        if (cpp_EmitCloneRest(os, n) && NeedParentLinks()) os << "\t\t\ty->_AdoptChildren();" << std::endl;
+        if (options & OPT_STATS) os << "\t\t\tAST_STATS_CREATED(NODE_TYPE_" << name << ");" << std::endl;
+        if (options & OPT_INDEX) os << "\t\t\tASTIndex::Register(y, NODE_TYPE_" << name << ");" << std::endl;
+
+        os << "\t\t\trv = y;" << std::endl;
+        os << "\t\t\tbreak;" << std::endl;
+        os << "\t\t}" << std::endl;
+    }
+
+    os << "\t\tdefault: break;" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+
+    if (NeedParentLinks()) {
+        os << "\t\tfor (int i = 0; rv && i < rv->_ChildCount(); i ++) {" << std::endl;
+        os << "\t\t\tif (kids[i] && kids[i] == n->_Child(i)) {" << std::endl;
+        os << "\t\t\t\tkids[i]->_parent = const_cast<" << root << " *>(n);" << std::endl;
+        os << "\t\t\t\tkids[i]->_slot = i;" << std::endl;
+        os << "\t\t\t}" << std::endl;
+        os << "\t\t}" << std::endl << std::endl;
+    }
+
+    os << "\t\treturn rv;" << std::endl;
+    os << "\t}" << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitClonePath() -- Emit ASTClonePath(), which copies the path from the top of a tree down to one node
+//
+// With parent links, the path is found by following them up from the node; otherwise it is the stack of a
+// preorder search from the top.  The owned children off the path are copied with ASTClone().
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitClonePath(std::ofstream &os)
+{
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+
+    os << "template <class A>" << std::endl;
+    os << "inline " << root << " *ASTClonePath(const " << root << " *tree, const " << root << " *target, A &alloc, "
+            << root << " **copy = NULL) {" << std::endl;
+    os << "\tstd::vector<const " << root << " *> path;" << std::endl;
+    os << "\tstd::vector<int> slots;" << std::endl;
+    os << "\t" << root << " *kids[ASTCloneAccess::MAX_CHILDREN];" << std::endl;
+    os << "\t" << root << " *y = NULL;" << std::endl << std::endl;
+
+    os << "\tif (!tree || !target) return NULL;" << std::endl << std::endl;
+
+    if (NeedParentLinks()) {
+        os << "\tfor (const " << root << " *n = target; ; n = n->_GetParent()) {" << std::endl;
+        os << "\t\tif (!n) return NULL;" << std::endl;
+        os << "\t\tpath.push_back(n);" << std::endl;
+        os << "\t\tif (n == tree) break;" << std::endl;
+        os << "\t\tslots.push_back(n->_GetSlotIndex());" << std::endl;
+        os << "\t}" << std::endl << std::endl;
+    } else {
+        os << "\tstruct Frame { const " << root << " *n; int next; };" << std::endl;
+        os << "\tFrame top = { tree, 0 };" << std::endl;
+        os << "\tstd::vector<Frame> stack(1, top);" << std::endl << std::endl;
+
+        os << "\twhile (stack.back().n != target) {" << std::endl;
+        os << "\t\tFrame &f = stack.back();" << std::endl << std::endl;
+        os << "\t\tif (f.next == f.n->_ChildCount()) {" << std::endl;
+        os << "\t\t\tstack.pop_back();" << std::endl;
+        os << "\t\t\tif (stack.empty()) return NULL;" << std::endl;
+        os << "\t\t\tcontinue;" << std::endl;
+        os << "\t\t}" << std::endl << std::endl;
+        os << "\t\tFrame g = { f.n->_Child(f.next ++), 0 };" << std::endl;
+        os << "\t\tif (g.n) stack.push_back(g);" << std::endl;
+        os << "\t}" << std::endl << std::endl;
+
+        os << "\tfor (size_t i = stack.size(); i --; ) {" << std::endl;
+        os << "\t\tpath.push_back(stack[i].n);" << std::endl;
+        os << "\t\tif (i) slots.push_back(stack[i - 1].next - 1);" << std::endl;
+        os << "\t}" << std::endl << std::endl;
+    }
+
+    os << "\tfor (size_t i = 0; i < path.size(); i ++) {" << std::endl;
+    os << "\t\tfor (int k = 0; k < path[i]->_ChildCount(); k ++) kids[k] = path[i]->_Child(k);" << std::endl;
+    if (HasOwnedAttrs()) {
+        os << "\t\tfor (int k = 0; k < path[i]->_ChildCount(); k ++) {" << std::endl;
+        os << "\t\t\tif (!kids[k] || (i && k == slots[i - 1])) continue;" << std::endl;
+        os << "\t\t\tif (ASTNodeMeta::ChildTable(path[i]->_GetTag()).slots[k].owned) kids[k] = ASTClone(kids[k], alloc);"
+                << std::endl;
+        os << "\t\t}" << std::endl;
+    }
+
+    os << "\t\tif (i) kids[slots[i - 1]] = y;" << std::endl << std::endl;
+    os << "\t\ty = ASTCloneAccess::Make(path[i], alloc, kids);" << std::endl;
+    os << "\t\tif (i == 0 && copy) *copy = y;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\treturn y;" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline " << root << " *ASTClonePath(const " << root << " *tree, const " << root << " *target, " << root
+            << " **copy = NULL) {" << std::endl;
+    os << "\tASTHeap heap;" << std::endl;
+    os << "\treturn ASTClonePath(tree, target, heap, copy);" << std::endl;
+    os << "}" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitClone() -- Emit the clones (--clone only)
+//
+// ASTClone() walks the tree in postorder with an explicit stack, like the dumper: the copies of the children of
+// a node are on the top of a second stack when the node is copied, and are replaced there by the copy.  A child
+// for which share() returns true is not copied, unless it is owned; the copy points to it too.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitClone(std::ofstream &os)
+{
+    if (!(options & OPT_CLONE)) return;
+
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+    int maxKids = 1;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        if (nl->elem()->GetChildCount() > maxKids) maxKids = nl->elem()->GetChildCount();
+    }
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTHeap -- the default allocator of the clones; these are deleted as usual" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "struct ASTHeap {" << std::endl;
+    os << "\tvoid *operator()(size_t n) const { return ::operator new(n); }" << std::endl;
+    os << "};" << std::endl << std::endl << std::endl;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTCloneAccess -- copy the nodes one at a time" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "struct ASTCloneAccess {" << std::endl;
+    os << "\tenum { MAX_CHILDREN = " << maxKids << " };" << std::endl << std::endl;
+    os << "\tstruct ShareNone { bool operator()(const " << root << " *) const { return false; } };" << std::endl
+            << std::endl;
+
+    cpp_EmitCloneMake(os);
+
+    os << "};" << std::endl << std::endl << std::endl;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTClone() copies a subtree; ASTClonePath() copies only the path down to target" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class A, class S>" << std::endl;
+    os << "inline " << root << " *ASTClone(const " << root << " *tree, A &alloc, S share) {" << std::endl;
+    os << "\tstruct Frame { const " << root << " *n; int next, count; };" << std::endl;
+    os << "\tstd::vector<Frame> stack;" << std::endl;
+    os << "\tstd::vector<" << root << " *> done;" << std::endl << std::endl;
+
+    os << "\tif (!tree) return NULL;" << std::endl << std::endl;
+
+    os << "\tFrame top = { tree, 0, tree->_ChildCount() };" << std::endl;
+    os << "\tstack.push_back(top);" << std::endl << std::endl;
+
+    os << "\twhile (!stack.empty()) {" << std::endl;
+    os << "\t\tFrame &f = stack.back();" << std::endl << std::endl;
+    os << "\t\tif (f.next < f.count) {" << std::endl;
+    os << "\t\t\t" << root << " *c = f.n->_Child(f.next ++);" << std::endl << std::endl;
+    if (HasOwnedAttrs()) {
+        os << "\t\t\tif (!c || (!ASTNodeMeta::ChildTable(f.n->_GetTag()).slots[f.next - 1].owned && share(c))) "
+                "done.push_back(c);" << std::endl;
+    } else {
+        os << "\t\t\tif (!c || share(c)) done.push_back(c);" << std::endl;
+    }
+    os << "\t\t\telse { Frame g = { c, 0, c->_ChildCount() }; stack.push_back(g); }" << std::endl;
+    os << "\t\t\tcontinue;" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tsize_t k = done.size() - f.count;" << std::endl;
+    os << "\t\t" << root << " *y = ASTCloneAccess::Make(f.n, alloc, done.data() + k);" << std::endl << std::endl;
+    os << "\t\tdone.resize(k);" << std::endl;
+    os << "\t\tdone.push_back(y);" << std::endl;
+    os << "\t\tstack.pop_back();" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\treturn done.back();" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "template <class A>" << std::endl;
+    os << "inline " << root << " *ASTClone(const " << root << " *tree, A &alloc) {" << std::endl;
+    os << "\treturn ASTClone(tree, alloc, ASTCloneAccess::ShareNone());" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline " << root << " *ASTClone(const " << root << " *tree) {" << std::endl;
+    os << "\tASTHeap heap;" << std::endl;
+    os << "\treturn ASTClone(tree, heap);" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    cpp_EmitClonePath(os);
+
+    //
+    // -- the Clone() functions of the nodes keep the type
+    //    ------------------------------------------------
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        std::string name = nl->elem()->Get_Name()->Get_Name();
+
+        os << "inline " << name << " *" << name << "::Clone(void) const { return static_cast<" << name
+                << " *>(ASTClone(this)); }" << std::endl;
+        os << "template <class A> inline " << name << " *" << name << "::Clone(A &alloc) const { return static_cast<"
+                << name << " *>(ASTClone(this, alloc)); }" << std::endl;
+    }
+
+    os << std::endl << std::endl;
+}
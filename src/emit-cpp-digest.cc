@@ -0,0 +1,358 @@
+//===================================================================================================================
+// emit-cpp-digest.cc -- This file is responsible for emitting the CPP cached subtree digests
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// With the --digest option, every node can give a 128-bit digest of the subtree below it: a hash of its node
+// type, the values of the attributes its Factory() function takes and the digests of its children.  The digest is
+// computed the first time it is asked for and kept in the node, with a bit in the word that tracks the cached
+// computed attributes.  The setters already clear that word on the path to the root, so a change anywhere in a
+// tree leaves the digests of the other subtrees in place, and comparing two subtrees is comparing two digests.
+//
+// The node type is hashed as a constant computed here from the node name and the names and types of the hashed
+// attributes, rather than as the node type tag, so a digest stays the same from one build of the program to the
+// next unless the node itself changes in the source.  That makes the digests usable as the keys of a cache kept
+// on disk.  The hash is MurmurHash3 (x64, 128 bits) fed 64 bits at a time; it is fast and spreads well, but it
+// is not a cryptographic hash.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+// 2026-10-18    N/A    v0.1.1   ADCL  Keep Stale() warning-free when no node has children
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+
+extern void cpp_DumpAttrs(Node *node, std::vector<Attribute *> &parms, std::vector<Node *> &owners, size_t &kids,
+        size_t &vals);
+extern void cpp_EmitDumpValue(std::ofstream &os, Node *owner, Attribute *a);
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_DigestSeed() -- Get the constant that stands for a node type in its digests: an FNV-1a hash of the node name
+//                     and the type and name of each hashed attribute, in order
+//-------------------------------------------------------------------------------------------------------------------
+static std::string cpp_DigestSeed(Node *node, std::vector<Attribute *> &parms)
+{
+    std::string sig = node->Get_Name()->Get_Name();
+    unsigned long long h = 0xcbf29ce484222325ull;
+    char buf[32];
+
+    for (size_t i = 0; i < parms.size(); i ++) {
+        sig += ";" + parms[i]->Get_Type()->Get_Name() + (parms[i]->Get_Type()->Get_Kind() == NODE ? " *" : " ")
+                + parms[i]->Get_Name();
+    }
+
+    for (size_t i = 0; i < sig.size(); i ++) {
+        h ^= (unsigned char)sig[i];
+        h *= 0x100000001b3ull;
+    }
+
+    snprintf(buf, sizeof(buf), "0x%016llxull", h);
+    return std::string(buf);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitDigestTypes() -- Emit the digest and the hash it is computed with (--digest only), which the root node
+//                          uses to keep its digest
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitDigestTypes(std::ofstream &os)
+{
+    if (!(options & OPT_DIGEST)) return;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTDigest -- the 128-bit digest of a subtree" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "struct ASTDigest {" << std::endl;
+    os << "\tuint64_t lo, hi;" << std::endl << std::endl;
+
+    os << "\tbool operator==(const ASTDigest &o) const { return lo == o.lo && hi == o.hi; }" << std::endl;
+    os << "\tbool operator!=(const ASTDigest &o) const { return lo != o.lo || hi != o.hi; }" << std::endl;
+    os << "\tbool operator<(const ASTDigest &o) const { return hi < o.hi || (hi == o.hi && lo < o.lo); }" << std::endl
+            << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The digest as 32 hex digits, such as for a file name in a cache" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstd::string Hex(void) const {" << std::endl;
+    os << "\t\tstatic const char d[] = \"0123456789abcdef\";" << std::endl;
+    os << "\t\tstd::string rv(32, '0');" << std::endl << std::endl;
+    os << "\t\tfor (int i = 0; i < 16; i ++) {" << std::endl;
+    os << "\t\t\trv[15 - i] = d[(hi >> (4 * i)) & 0xf];" << std::endl;
+    os << "\t\t\trv[31 - i] = d[(lo >> (4 * i)) & 0xf];" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\treturn rv;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstruct Hash { size_t operator()(const ASTDigest &d) const { return (size_t)d.lo; } };" << std::endl;
+    os << "};" << std::endl << std::endl << std::endl;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTDigester -- MurmurHash3 (x64, 128 bits), fed 64 bits at a time" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "class ASTDigester {" << std::endl;
+    os << "private:" << std::endl;
+    os << "\tuint64_t h1, h2, k, n;" << std::endl << std::endl;
+
+    os << "\tstatic uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }" << std::endl;
+    os << "\tstatic uint64_t K1(uint64_t x) { return Rotl(x * 0x87c37b91114253d5ull, 31) * 0x4cf5ad432745937full; }"
+            << std::endl;
+    os << "\tstatic uint64_t K2(uint64_t x) { return Rotl(x * 0x4cf5ad432745937full, 33) * 0x87c37b91114253d5ull; }"
+            << std::endl;
+    os << "\tstatic uint64_t Mix(uint64_t x) {" << std::endl;
+    os << "\t\tx ^= x >> 33; x *= 0xff51afd7ed558ccdull;" << std::endl;
+    os << "\t\tx ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ull;" << std::endl;
+    os << "\t\treturn x ^ (x >> 33);" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Bytes are read little-endian, so the digests are the same on any machine" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic uint64_t Load(const unsigned char *b, size_t len) {" << std::endl;
+    os << "\t\tuint64_t w = 0;" << std::endl;
+    os << "\t\tfor (size_t i = 0; i < len; i ++) w |= (uint64_t)b[i] << (8 * i);" << std::endl;
+    os << "\t\treturn w;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\texplicit ASTDigester(uint64_t seed = 0) : h1(seed), h2(seed), k(0), n(0) { }" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tvoid Add(uint64_t w) {" << std::endl;
+    os << "\t\tif (!(n ++ & 1)) { k = w; return; }" << std::endl << std::endl;
+    os << "\t\th1 ^= K1(k); h1 = Rotl(h1, 27) + h2; h1 = h1 * 5 + 0x52dce729;" << std::endl;
+    os << "\t\th2 ^= K2(w); h2 = Rotl(h2, 31) + h1; h2 = h2 * 5 + 0x38495ab5;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tvoid Add(const void *p, size_t len) {" << std::endl;
+    os << "\t\tconst unsigned char *b = static_cast<const unsigned char *>(p);" << std::endl << std::endl;
+    os << "\t\tfor ( ; len >= 8; b += 8, len -= 8) Add(Load(b, 8));" << std::endl;
+    os << "\t\tif (len) Add(Load(b, len));" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tvoid Add(const ASTDigest &d) { Add(d.lo); Add(d.hi); }" << std::endl << std::endl;
+
+    os << "\tASTDigest Digest(void) const {" << std::endl;
+    os << "\t\tuint64_t a = h1 ^ (n & 1 ? K1(k) : 0), b = h2;" << std::endl << std::endl;
+    os << "\t\ta ^= n * 8; b ^= n * 8;" << std::endl;
+    os << "\t\ta += b; b += a;" << std::endl;
+    os << "\t\ta = Mix(a); b = Mix(b);" << std::endl;
+    os << "\t\ta += b; b += a;" << std::endl << std::endl;
+    os << "\t\tASTDigest rv = { a, b };" << std::endl;
+    os << "\t\treturn rv;" << std::endl;
+    os << "\t}" << std::endl;
+    os << "};" << std::endl << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitDigestValues() -- Emit the value hashers for the built-in types
+//
+// A value is hashed by what it is, not how it is stored: an interned attribute by its value rather than its
+// index, and a floating point zero the same whatever its sign.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitDigestValues(std::ofstream &os)
+{
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTDigestValue() for the built-in types; add overloads for the others" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class H, class T>" << std::endl;
+    os << "inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type" << std::endl;
+    os << "ASTDigestValue(H &h, T v) { h.Add((uint64_t)v); }" << std::endl << std::endl;
+
+    os << "template <class H, class T>" << std::endl;
+    os << "inline typename std::enable_if<std::is_floating_point<T>::value>::type ASTDigestValue(H &h, T v) {"
+            << std::endl;
+    os << "\tdouble d = (v == 0 ? 0.0 : (double)v);" << std::endl;
+    os << "\tuint64_t w;" << std::endl << std::endl;
+    os << "\tmemcpy(&w, &d, sizeof(w));" << std::endl;
+    os << "\th.Add(w);" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "template <class H>" << std::endl;
+    os << "inline void ASTDigestValue(H &h, const std::string &v) {" << std::endl;
+    os << "\th.Add((uint64_t)v.size());" << std::endl;
+    os << "\th.Add(v.data(), v.size());" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    //
+    // -- the built-in location type is its line and file name
+    //    ----------------------------------------------------
+    if (UsesLocation()) {
+        os << "template <class H>" << std::endl;
+        os << "inline void ASTDigestValue(H &h, const ASTLocation &v) {" << std::endl;
+        os << "\th.Add((uint64_t)v.Line());" << std::endl;
+        os << "\tASTDigestValue(h, v.File());" << std::endl;
+        os << "}" << std::endl << std::endl;
+    }
+
+    os << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitDigest() -- Emit the computation of the digests (--digest only)
+//
+// ASTDigestAccess is a friend of every node, so it reads the attributes directly.  Update() collects the nodes
+// below the top whose digests are not up to date (a node whose digest is up to date has a subtree that is, so
+// the walk stops there) and computes them in reverse, which puts every child before its parent.  Nothing
+// recurses, so a subtree of any depth can be digested.  The digests are cached like the computed attributes, so
+// two threads must not ask for the digests of the same tree at once.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitDigest(std::ofstream &os)
+{
+    if (!(options & OPT_DIGEST)) return;
+
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+
+    cpp_EmitDigestValues(os);
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTDigestAccess -- compute the digests of the subtrees that have changed" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "struct ASTDigestAccess {" << std::endl;
+    os << "\tstatic const unsigned int DIGESTED = 0x80000000u;" << std::endl << std::endl;
+
+    //
+    // -- the children of each node type that the walk goes down to
+    //    ---------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Push the children of n whose digests are not up to date" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic void Stale(" << root << " *n, std::vector<" << root << " *> &w) {" << std::endl;
+    os << "\t\t(void)w;" << std::endl;                      // -- unused when no node has children
+    os << "\t\tswitch (n->_tag) {" << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> parms;
+        std::vector<Node *> owners;
+        size_t kids = 0, vals = 0;
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+
+        cpp_DumpAttrs(n, parms, owners, kids, vals);
+        if (!kids) continue;
+
+        std::string name = n->Get_Name()->Get_Name();
+
+        os << "\t\tcase NODE_TYPE_" << name << ": {" << std::endl;
+        os << "\t\t\t" << name << " *x = static_cast<" << name << " *>(n);" << std::endl;
+
+        for (size_t i = 0; i < parms.size(); i ++) {
+            if (parms[i]->Get_Type()->Get_Kind() != NODE) continue;
+
+            std::string c = "x->" + parms[i]->Get_Name();
+            os << "\t\t\tif (" << c << " && !(" << c << "->_valid & DIGESTED)) w.push_back(" << c << ");" << std::endl;
+        }
+
+        os << "\t\t\tbreak;" << std::endl;
+        os << "\t\t}" << std::endl;
+    }
+
+    os << "\t\tdefault: break;" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the hash of one node, once its children are up to date
+    //    ------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Hash the node type, the values and the digests of the children of n" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\ttemplate <class H> static void Kid(H &h, const " << root << " *c) {" << std::endl;
+    os << "\t\tif (c) h.Add(c->_digest);" << std::endl;
+    os << "\t\telse { h.Add((uint64_t)0); h.Add((uint64_t)0); }" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\ttemplate <class H> static void Hash(H &h, " << root << " *n) {" << std::endl;
+    os << "\t\tswitch (n->_tag) {" << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> parms;
+        std::vector<Node *> owners;
+        size_t kids = 0, vals = 0;
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+
+        cpp_DumpAttrs(n, parms, owners, kids, vals);
+
+        std::string name = n->Get_Name()->Get_Name();
+
+        os << "\t\tcase NODE_TYPE_" << name << ": {" << std::endl;
+        if (parms.size()) os << "\t\t\t" << name << " *x = static_cast<" << name << " *>(n);" << std::endl;
+        os << "\t\t\th.Add((uint64_t)" << cpp_DigestSeed(n, parms) << ");" << std::endl;
+
+        for (size_t i = 0; i < parms.size(); i ++) {
+            if (parms[i]->Get_Type()->Get_Kind() == NODE) {
+                os << "\t\t\tKid(h, x->" << parms[i]->Get_Name() << ");" << std::endl;
+            } else {
+                os << "\t\t\tASTDigestValue(h, ";
+                cpp_EmitDumpValue(os, owners[i], parms[i]);
+                os << ");" << std::endl;
+            }
+        }
+
+        os << "\t\t\tbreak;" << std::endl;
+        os << "\t\t}" << std::endl;
+    }
+
+    os << "\t\tdefault: break;" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- bring the digests below top up to date, children first
+    //    ------------------------------------------------------
+    os << "\ttemplate <class H> static void Update(" << root << " *top) {" << std::endl;
+    os << "\t\tstd::vector<" << root << " *> work(1, top), order;" << std::endl << std::endl;
+    os << "\t\twhile (!work.empty()) {" << std::endl;
+    os << "\t\t\t" << root << " *n = work.back();" << std::endl;
+    os << "\t\t\twork.pop_back();" << std::endl;
+    os << "\t\t\torder.push_back(n);" << std::endl;
+    os << "\t\t\tStale(n, work);" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tfor (size_t i = order.size(); i --; ) {" << std::endl;
+    os << "\t\t\t" << root << " *n = order[i];" << std::endl;
+    os << "\t\t\tif (n->_valid & DIGESTED) continue;" << std::endl << std::endl;
+    os << "\t\t\tH h;" << std::endl;
+    os << "\t\t\tHash(h, n);" << std::endl;
+    os << "\t\t\tn->_digest = h.Digest();" << std::endl;
+    os << "\t\t\tn->_Cache(DIGESTED);" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "template <class H>" << std::endl;
+    os << "inline const ASTDigest &" << root << "::_GetDigest(void) {" << std::endl;
+    os << "\tif (!(_valid & ASTDigestAccess::DIGESTED)) ASTDigestAccess::Update<H>(this);" << std::endl;
+    os << "\treturn _digest;" << std::endl;
+    os << "}" << std::endl;
+    os << std::endl << std::endl;
+}
@@ -0,0 +1,619 @@
+//===================================================================================================================
+// emit-cpp-dump.cc -- This file is responsible for emitting the CPP tree dumper and the reader that loads a dump
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// With the --dump option, a tree can be written out as text and read back in.  The dump has one line for each
+// node, in postorder: the node type name, then the value of each attribute its Factory() function takes (except
+// the children), separated by single spaces.  A NULL child is a line of its own, "-".  So a node comes after its
+// children, and the reader rebuilds the tree with a stack of the nodes read so far, passing the top few to the
+// Factory() function of the next node; neither the writer nor the reader recurses.
+//
+// The values are formatted by ASTDumpValue() and parsed by ASTLoadValue(), which are emitted for the integer,
+// floating point, enum, bool and std::string types.  A string is written as its length, a colon and its bytes, so
+// nothing needs to be escaped.  The writer appends to one growing buffer and does not use iostreams.  The dump
+// and load functions are templates only so that the program can add the overloads for its own types after the
+// header is included (they are found when the templates are instantiated).
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+// 2026-10-18    N/A    v0.1.1   ADCL  Keep Children() warning-free when no node has children
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <vector>
+
+
+extern std::string cpp_BitsValue(Node *node, Attribute *a, const std::string &obj);
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_DumpAttrs() -- Get the attributes that Factory() takes for a node, in the order it takes them (inherited
+//                    first), along with the node that defines each; kids and vals count the children and values.
+//                    These are also the attributes that the digest covers.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_DumpAttrs(Node *node, std::vector<Attribute *> &parms, std::vector<Node *> &owners, size_t &kids,
+        size_t &vals)
+{
+    if (!node) return;
+
+    cpp_DumpAttrs(node->Get_Parent(), parms, owners, kids, vals);
+
+    for (AttrList *al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        Attribute *a = al->elem();
+
+        if (a->Get_Flags() & (NOINIT | COMPUTED | LAZY)) continue;
+
+        parms.push_back(a);
+        owners.push_back(node);
+        if (a->Get_Type()->Get_Kind() == NODE) kids ++;
+        else vals ++;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitDumpValue() -- Emit the value of an attribute read from the node x
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitDumpValue(std::ofstream &os, Node *owner, Attribute *a)
+{
+    if (a->Get_Bits()) {
+        os << cpp_BitsValue(owner, a, "x->");
+    } else if (a->Get_Flags() & INTERNED) {
+        os << "ASTIntern<" << a->Get_Type()->Get_Name() << ">::Get(x->" << a->Get_Name() << ")";
+    } else os << "x->" << a->Get_Name();
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitDumpBuffers() -- Emit the writer's buffer and the reader's cursor
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitDumpBuffers(std::ofstream &os)
+{
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTDumpWriter -- the growing buffer a dump is written into" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "class ASTDumpWriter {" << std::endl;
+    os << "private:" << std::endl;
+    os << "\tstd::vector<char> buf;" << std::endl;
+    os << "\tsize_t len;" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\texplicit ASTDumpWriter(size_t reserve = 65536) : buf(reserve ? reserve : 1), len(0) { }" << std::endl
+            << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\t//" << std::endl;
+    os << "\t// -- Make room for n more bytes and return where they go; Used(n) then keeps them" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tchar *Room(size_t n) {" << std::endl;
+    os << "\t\tif (len + n > buf.size()) buf.resize(buf.size() * 2 > len + n ? buf.size() * 2 : len + n);" << std::endl;
+    os << "\t\treturn &buf[len];" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tvoid Used(size_t n) { len += n; }" << std::endl;
+    os << "\tvoid Put(char c) { *Room(1) = c; len ++; }" << std::endl;
+    os << "\tvoid Put(const char *s, size_t n) { memcpy(Room(n), s, n); len += n; }" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tconst char *Data(void) const { return buf.data(); }" << std::endl;
+    os << "\tsize_t Size(void) const { return len; }" << std::endl;
+    os << "\tstd::string Str(void) const { return std::string(buf.data(), len); }" << std::endl;
+    os << "\tvoid Clear(void) { len = 0; }" << std::endl;
+    os << "\tbool Write(FILE *f) const { return fwrite(buf.data(), 1, len, f) == len; }" << std::endl;
+    os << "};" << std::endl << std::endl << std::endl;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTLoadReader -- the cursor of the reader over a dump, which must outlive it" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "class ASTLoadReader {" << std::endl;
+    os << "private:" << std::endl;
+    os << "\tconst char *p;" << std::endl;
+    os << "\tconst char *end;" << std::endl;
+    os << "\tint line;" << std::endl;
+    os << "\tbool ok;" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tASTLoadReader(const char *d, size_t n) : p(d), end(d + n), line(1), ok(true) { }" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\t//" << std::endl;
+    os << "\t// -- Whether the dump has been read without error so far, and the line being read" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tbool Ok(void) const { return ok; }" << std::endl;
+    os << "\tint Line(void) const { return line; }" << std::endl;
+    os << "\tbool Fail(void) { ok = false; return false; }" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Skip to the next line that is not blank; false at the end of the dump" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tbool NextLine(void) {" << std::endl;
+    os << "\t\tfor ( ; p < end && (*p == '\\n' || *p == '\\r'); p ++) if (*p == '\\n') line ++;" << std::endl;
+    os << "\t\treturn ok && p < end;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The next field, up to a space or the end of the line; the separators" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tsize_t Word(const char *&s) {" << std::endl;
+    os << "\t\ts = p;" << std::endl;
+    os << "\t\twhile (p < end && *p != ' ' && *p != '\\n' && *p != '\\r') p ++;" << std::endl;
+    os << "\t\treturn (size_t)(p - s);" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tbool Space(void) { if (p < end && *p == ' ') { p ++; return true; } return Fail(); }" << std::endl;
+    os << "\tbool EndLine(void) { return (p == end || *p == '\\n' || *p == '\\r') ? true : Fail(); }" << std::endl
+            << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Take the next n bytes as they are (the bytes of a string)" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tbool Bytes(size_t n, const char *&s) {" << std::endl;
+    os << "\t\tif ((size_t)(end - p) < n) return Fail();" << std::endl;
+    os << "\t\tfor (s = p, p += n; n; n --) if (s[n - 1] == '\\n') line ++;" << std::endl;
+    os << "\t\treturn true;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The next integer, an optional '-' and the digits" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tsize_t Number(const char *&s) {" << std::endl;
+    os << "\t\ts = p;" << std::endl;
+    os << "\t\tif (p < end && *p == '-') p ++;" << std::endl;
+    os << "\t\twhile (p < end && *p >= '0' && *p <= '9') p ++;" << std::endl;
+    os << "\t\treturn (size_t)(p - s);" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tbool Expect(char c) { if (p < end && *p == c) { p ++; return true; } return Fail(); }" << std::endl;
+    os << "};" << std::endl << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitDumpValues() -- Emit the value writers and readers for the built-in types
+//
+// The integers are written in decimal by hand; the floating point values go through snprintf() and strtod()
+// with enough digits to come back the same.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitDumpValues(std::ofstream &os)
+{
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTDumpValue() and ASTLoadValue() for the built-in types; add overloads for the others" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class T>" << std::endl;
+    os << "inline typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type" << std::endl;
+    os << "ASTDumpValue(ASTDumpWriter &w, T v) {" << std::endl;
+    os << "\tchar tmp[24];" << std::endl;
+    os << "\tint n = 0;" << std::endl;
+    os << "\tunsigned long long u = (v < (T)1 && v != (T)0) ? 0ull - (unsigned long long)v : (unsigned long long)v;"
+            << std::endl << std::endl;
+    os << "\tdo { tmp[n ++] = (char)('0' + u % 10); u /= 10; } while (u);" << std::endl;
+    os << "\tif (v < (T)1 && v != (T)0) tmp[n ++] = '-';" << std::endl << std::endl;
+    os << "\tchar *p = w.Room(n);" << std::endl;
+    os << "\tfor (int i = 0; i < n; i ++) p[i] = tmp[n - 1 - i];" << std::endl;
+    os << "\tw.Used(n);" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "template <class T>" << std::endl;
+    os << "inline typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, bool>::type"
+            << std::endl;
+    os << "ASTLoadValue(ASTLoadReader &r, T &v) {" << std::endl;
+    os << "\tconst char *s;" << std::endl;
+    os << "\tsize_t n = r.Number(s), i = (n && *s == '-') ? 1 : 0;" << std::endl;
+    os << "\tunsigned long long u = 0;" << std::endl << std::endl;
+    os << "\tif (i == n) return r.Fail();" << std::endl;
+    os << "\tfor (size_t j = i; j < n; j ++) u = u * 10 + (unsigned long long)(s[j] - '0');" << std::endl << std::endl;
+    os << "\tv = (T)(i ? 0ull - u : u);" << std::endl;
+    os << "\treturn true;" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "template <class T>" << std::endl;
+    os << "inline typename std::enable_if<std::is_floating_point<T>::value>::type" << std::endl;
+    os << "ASTDumpValue(ASTDumpWriter &w, T v) {" << std::endl;
+    os << "\tw.Used(snprintf(w.Room(32), 32, \"%.*g\", (sizeof(T) > sizeof(float) ? 17 : 9), (double)v));"
+            << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "template <class T>" << std::endl;
+    os << "inline typename std::enable_if<std::is_floating_point<T>::value, bool>::type" << std::endl;
+    os << "ASTLoadValue(ASTLoadReader &r, T &v) {" << std::endl;
+    os << "\tconst char *s;" << std::endl;
+    os << "\tsize_t n = r.Word(s);" << std::endl;
+    os << "\tchar tmp[64], *e;" << std::endl << std::endl;
+    os << "\tif (n == 0 || n >= sizeof(tmp)) return r.Fail();" << std::endl;
+    os << "\tmemcpy(tmp, s, n);" << std::endl;
+    os << "\ttmp[n] = 0;" << std::endl;
+    os << "\tv = (T)strtod(tmp, &e);" << std::endl;
+    os << "\treturn (e == tmp + n) ? true : r.Fail();" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "template <class T>" << std::endl;
+    os << "inline typename std::enable_if<std::is_enum<T>::value>::type ASTDumpValue(ASTDumpWriter &w, T v) {"
+            << std::endl;
+    os << "\tASTDumpValue(w, (long long)v);" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "template <class T>" << std::endl;
+    os << "inline typename std::enable_if<std::is_enum<T>::value, bool>::type ASTLoadValue(ASTLoadReader &r, T &v) {"
+            << std::endl;
+    os << "\tlong long i;" << std::endl;
+    os << "\tif (!ASTLoadValue(r, i)) return false;" << std::endl;
+    os << "\tv = (T)i;" << std::endl;
+    os << "\treturn true;" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline void ASTDumpValue(ASTDumpWriter &w, bool v) { w.Put(v ? '1' : '0'); }" << std::endl;
+    os << "inline bool ASTLoadValue(ASTLoadReader &r, bool &v) {" << std::endl;
+    os << "\tconst char *s;" << std::endl;
+    os << "\tif (r.Word(s) != 1 || (*s != '0' && *s != '1')) return r.Fail();" << std::endl;
+    os << "\tv = (*s == '1');" << std::endl;
+    os << "\treturn true;" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline void ASTDumpValue(ASTDumpWriter &w, const std::string &v) {" << std::endl;
+    os << "\tASTDumpValue(w, v.size());" << std::endl;
+    os << "\tw.Put(':');" << std::endl;
+    os << "\tw.Put(v.data(), v.size());" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline bool ASTLoadValue(ASTLoadReader &r, std::string &v) {" << std::endl;
+    os << "\tsize_t n;" << std::endl;
+    os << "\tconst char *s;" << std::endl;
+    os << "\tif (!ASTLoadValue(r, n) || !r.Expect(':') || !r.Bytes(n, s)) return false;" << std::endl;
+    os << "\tv.assign(s, n);" << std::endl;
+    os << "\treturn true;" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    //
+    // -- the built-in location type is its line and file name
+    //    ----------------------------------------------------
+    if (UsesLocation()) {
+        os << "inline void ASTDumpValue(ASTDumpWriter &w, const ASTLocation &v) {" << std::endl;
+        os << "\tASTDumpValue(w, v.Line());" << std::endl;
+        os << "\tw.Put(' ');" << std::endl;
+        os << "\tASTDumpValue(w, v.File());" << std::endl;
+        os << "}" << std::endl << std::endl;
+
+        os << "inline bool ASTLoadValue(ASTLoadReader &r, ASTLocation &v) {" << std::endl;
+        os << "\tunsigned int line;" << std::endl;
+        os << "\tstd::string file;" << std::endl;
+        os << "\tif (!ASTLoadValue(r, line) || !r.Space() || !ASTLoadValue(r, file)) return false;" << std::endl;
+        os << "\tv = ASTLocation(file, line);" << std::endl;
+        os << "\treturn true;" << std::endl;
+        os << "}" << std::endl << std::endl;
+    }
+
+    os << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitDump() -- Emit the tree dumper and reader (--dump only)
+//
+// ASTDumpAccess is a friend of every node, so it reads the attributes directly (including those without a Get_
+// function).  The node type names are looked up with a binary search of a table sorted here.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitDump(std::ofstream &os)
+{
+    if (!(options & OPT_DUMP)) return;
+
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+    std::vector<std::string> names;
+    size_t maxKids = 1;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> parms;
+        std::vector<Node *> owners;
+        size_t kids = 0, vals = 0;
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+
+        cpp_DumpAttrs(n, parms, owners, kids, vals);
+        names.push_back(n->Get_Name()->Get_Name());
+        if (kids > maxKids) maxKids = kids;
+    }
+
+    std::sort(names.begin(), names.end());
+
+    cpp_EmitDumpBuffers(os);
+    cpp_EmitDumpValues(os);
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTDumpAccess -- the code for each node type that the dump and load functions use" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "struct ASTDumpAccess {" << std::endl;
+    os << "\tenum { MAX_CHILDREN = " << maxKids << " };" << std::endl << std::endl;
+
+    //
+    // -- the node type names, sorted, to find the node type of a line
+    //    ------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The node type of a name; -1 if there is no such node type" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic int Kind(const char *s, size_t n) {" << std::endl;
+    os << "\t\tstatic const struct { const char *name; size_t len; int kind; } names[] = {" << std::endl;
+
+    for (size_t i = 0; i < names.size(); i ++) {
+        os << "\t\t\t{ \"" << names[i] << "\", " << names[i].size() << ", NODE_TYPE_" << names[i] << " }"
+                << (i + 1 < names.size() ? "," : "") << std::endl;
+    }
+
+    os << "\t\t};" << std::endl;
+    os << "\t\tint lo = 0, hi = " << names.size() << ";" << std::endl << std::endl;
+    os << "\t\twhile (lo < hi) {" << std::endl;
+    os << "\t\t\tint mid = (lo + hi) / 2;" << std::endl;
+    os << "\t\t\tint d = memcmp(s, names[mid].name, n < names[mid].len ? n : names[mid].len);" << std::endl;
+    os << "\t\t\tif (d == 0) d = (n < names[mid].len ? -1 : (n > names[mid].len ? 1 : 0));" << std::endl;
+    os << "\t\t\tif (d == 0) return names[mid].kind;" << std::endl;
+    os << "\t\t\tif (d < 0) hi = mid; else lo = mid + 1;" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\treturn -1;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the children of a node, in the order of its Factory() parameters
+    //    ----------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Get the children of a node that Factory() takes into c; returns how many" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic int Children(const " << root << " *n, " << root << " **c) {" << std::endl;
+    os << "\t\t(void)c;" << std::endl;                      // -- unused when no node has children
+    os << "\t\tswitch (n->_GetTag()) {" << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::string name = n->Get_Name()->Get_Name();
+        std::vector<Attribute *> parms;
+        std::vector<Node *> owners;
+        size_t kids = 0, vals = 0;
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+
+        cpp_DumpAttrs(n, parms, owners, kids, vals);
+        if (!kids) continue;
+
+        os << "\t\tcase NODE_TYPE_" << name << ": {" << std::endl;
+        os << "\t\t\tconst " << name << " *x = static_cast<const " << name << " *>(n);" << std::endl;
+
+        for (size_t i = 0, k = 0; i < parms.size(); i ++) {
+            if (parms[i]->Get_Type()->Get_Kind() != NODE) continue;
+            os << "\t\t\tc[" << k ++ << "] = x->" << parms[i]->Get_Name() << ";" << std::endl;
+        }
+
+        os << "\t\t\treturn " << kids << ";" << std::endl;
+        os << "\t\t}" << std::endl;
+    }
+
+    os << "\t\tdefault: return 0;" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the line of a node
+    //    ------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Write the line of a node, without its children" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\ttemplate <class W> static void Line(W &w, const " << root << " *n) {" << std::endl;
+    os << "\t\tswitch (n->_GetTag()) {" << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::string name = n->Get_Name()->Get_Name();
+        std::vector<Attribute *> parms;
+        std::vector<Node *> owners;
+        size_t kids = 0, vals = 0;
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+
+        cpp_DumpAttrs(n, parms, owners, kids, vals);
+
+        os << "\t\tcase NODE_TYPE_" << name << ": {" << std::endl;
+        if (vals) os << "\t\t\tconst " << name << " *x = static_cast<const " << name << " *>(n);" << std::endl;
+        os << "\t\t\tw.Put(\"" << name << "\", " << name.size() << ");" << std::endl;
+
+        for (size_t i = 0; i < parms.size(); i ++) {
+            if (parms[i]->Get_Type()->Get_Kind() == NODE) continue;
+            os << "\t\t\tw.Put(' '); ASTDumpValue(w, ";
+            cpp_EmitDumpValue(os, owners[i], parms[i]);
+            os << ");" << std::endl;
+        }
+
+        os << "\t\t\tbreak;" << std::endl;
+        os << "\t\t}" << std::endl;
+    }
+
+    os << "\t\tdefault: break;" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tw.Put('\\n');" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the number of children of a node type, and building a node from the rest of its line
+    //    ------------------------------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The number of children Factory() takes for a node type" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic size_t ChildCount(int k) {" << std::endl;
+    os << "\t\tswitch (k) {" << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> parms;
+        std::vector<Node *> owners;
+        size_t kids = 0, vals = 0;
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+
+        cpp_DumpAttrs(n, parms, owners, kids, vals);
+        if (kids) os << "\t\tcase NODE_TYPE_" << n->Get_Name()->Get_Name() << ": return " << kids
+                << ";" << std::endl;
+    }
+
+    os << "\t\tdefault: return 0;" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Read the values of a node of type k and build it with the children c; NULL on an error" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\ttemplate <class R> static " << root << " *Build(R &r, int k, " << root << " **c) {" << std::endl;
+    os << "\t\t(void)c;" << std::endl << std::endl;
+    os << "\t\tswitch (k) {" << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::string name = n->Get_Name()->Get_Name();
+        std::vector<Attribute *> parms;
+        std::vector<Node *> owners;
+        size_t kids = 0, vals = 0;
+        size_t kid = 0, val = 0;
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+
+        cpp_DumpAttrs(n, parms, owners, kids, vals);
+
+        os << "\t\tcase NODE_TYPE_" << name << ": {" << std::endl;
+
+        for (size_t i = 0; i < parms.size(); i ++) {
+            Attribute *a = parms[i];
+
+            if (a->Get_Type()->Get_Kind() == NODE) {
+                os << "\t\t\tif (c[" << kid << "] && !ASTIsA<" << a->Get_Type()->Get_Name() << ">(c[" << kid
+                        << "])) return NULL;" << std::endl;
+                kid ++;
+            } else {
+                os << "\t\t\t" << a->Get_Type()->Get_Name() << " v" << val << ";" << std::endl;
+                os << "\t\t\tif (!r.Space() || !ASTLoadValue(r, v" << val << ")) return NULL;" << std::endl;
+                val ++;
+            }
+        }
+
+        os << "\t\t\treturn " << name << "::Factory(";
+
+        //
+        // -- the parameters are in the order of the attributes, taking the next child or value in turn
+        //    -----------------------------------------------------------------------------------------
+        kid = val = 0;
+
+        for (size_t i = 0; i < parms.size(); i ++) {
+            Attribute *a = parms[i];
+
+            if (i) os << ", ";
+            if (a->Get_Type()->Get_Kind() == NODE) {
+                os << "static_cast<" << a->Get_Type()->Get_Name() << " *>(c[" << kid ++ << "])";
+            } else os << "v" << val ++;
+        }
+
+        os << ");" << std::endl;
+        os << "\t\t}" << std::endl;
+    }
+
+    os << "\t\tdefault: return NULL;" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl;
+    os << "};" << std::endl << std::endl << std::endl;
+
+    //
+    // -- the dump and load functions themselves
+    //    --------------------------------------
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTDump() -- write a tree to w, one line per node in postorder" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class W> void ASTDump(W &w, const " << root << " *tree) {" << std::endl;
+    os << "\tstruct Frame { const " << root << " *n; int next, count; " << root << " *c[ASTDumpAccess::MAX_CHILDREN]; };"
+            << std::endl;
+    os << "\tstd::vector<Frame> st;" << std::endl << std::endl;
+
+    os << "\tst.resize(1);" << std::endl;
+    os << "\tst.back().n = tree;" << std::endl;
+    os << "\tst.back().next = 0;" << std::endl;
+    os << "\tst.back().count = tree ? ASTDumpAccess::Children(tree, st.back().c) : 0;" << std::endl << std::endl;
+
+    os << "\twhile (!st.empty()) {" << std::endl;
+    os << "\t\tFrame &f = st.back();" << std::endl << std::endl;
+    os << "\t\tif (!f.n) { w.Put(\"-\\n\", 2); st.pop_back(); continue; }" << std::endl;
+    os << "\t\tif (f.next == f.count) { ASTDumpAccess::Line(w, f.n); st.pop_back(); continue; }" << std::endl
+            << std::endl;
+    os << "\t\tconst " << root << " *c = f.c[f.next ++];" << std::endl;
+    os << "\t\tst.resize(st.size() + 1);" << std::endl;
+    os << "\t\tst.back().n = c;" << std::endl;
+    os << "\t\tst.back().next = 0;" << std::endl;
+    os << "\t\tst.back().count = c ? ASTDumpAccess::Children(c, st.back().c) : 0;" << std::endl;
+    os << "\t}" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTLoad() -- read a tree dumped by ASTDump(); NULL with !r.Ok() on an error, at r.Line()" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class R> " << root << " *ASTLoad(R &r) {" << std::endl;
+    os << "\tstd::vector<" << root << " *> st;" << std::endl;
+    os << "\tstd::vector<" << root << " *> built;" << std::endl;
+    os << "\t" << root << " *c[ASTDumpAccess::MAX_CHILDREN];" << std::endl << std::endl;
+
+    os << "\twhile (r.NextLine()) {" << std::endl;
+    os << "\t\tconst char *s;" << std::endl;
+    os << "\t\tsize_t n = r.Word(s);" << std::endl << std::endl;
+
+    os << "\t\tif (n == 1 && *s == '-') {" << std::endl;
+    os << "\t\t\tif (!r.EndLine()) break;" << std::endl;
+    os << "\t\t\tst.push_back(NULL);" << std::endl;
+    os << "\t\t\tcontinue;" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+
+    os << "\t\tint k = ASTDumpAccess::Kind(s, n);" << std::endl;
+    os << "\t\tsize_t count = (k < 0 ? 0 : ASTDumpAccess::ChildCount(k));" << std::endl << std::endl;
+
+    os << "\t\tif (k < 0 || st.size() < count) { r.Fail(); break; }" << std::endl;
+    os << "\t\tfor (size_t i = 0; i < count; i ++) c[i] = st[st.size() - count + i];" << std::endl << std::endl;
+
+    os << "\t\t" << root << " *node = ASTDumpAccess::Build(r, k, c);" << std::endl;
+    os << "\t\tif (!node) { r.Fail(); break; }" << std::endl << std::endl;
+
+    os << "\t\tst.resize(st.size() - count);" << std::endl;
+    os << "\t\tst.push_back(node);" << std::endl;
+    os << "\t\tbuilt.push_back(node);" << std::endl;
+    os << "\t\tif (!r.EndLine()) break;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tif (r.Ok() && st.size() == 1) return st[0];" << std::endl << std::endl;
+
+    //
+    // -- on an error, delete what was built: with owned children, deleting the partial trees deletes them
+    //    ------------------------------------------------------------------------------------------------
+    os << "\tr.Fail();" << std::endl;
+    if (HasOwnedAttrs()) {
+        os << "\tfor (size_t i = 0; i < st.size(); i ++) delete st[i];" << std::endl;
+        os << "\t(void)built;" << std::endl;
+    } else {
+        os << "\tfor (size_t i = 0; i < built.size(); i ++) delete built[i];" << std::endl;
+    }
+    os << "\treturn NULL;" << std::endl;
+    os << "}" << std::endl;
+    os << std::endl << std::endl;
+}
@@ -0,0 +1,471 @@
+//===================================================================================================================
+// emit-cpp-flat.cc -- This file is responsible for emitting the CPP flattened form of the node families
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// A node declared with the flatten specifier is the root of a family: itself and all the nodes derived from it.
+// A tree of family nodes that is evaluated over and over (such as an expression) costs a virtual call and a
+// pointer chase per node each time.  ASTFlat<> holds the same tree as an array of operations in postorder, so
+// each operation comes after its operands.  An operation is the node type tag, the index of its payload and the
+// indexes of its operands.  The operands are the child attributes that hold family nodes; the payload is the rest
+// of the attributes the family nodes define, kept in one array per node type.
+//
+// The evaluator that is emitted runs through the operations once, handing each operation's payload and the values
+// of its operands to a function of the caller's evaluator class.  It dispatches with a computed goto where the
+// compiler supports it, and with a switch otherwise.  The concrete family nodes have a range of consecutive node
+// type tags, so the table of labels is indexed by the tag directly.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+// 2026-10-18    N/A    v0.1.1   ADCL  Leave the lazy attributes out of the payload
+// 2026-10-18    N/A    v0.1.1   ADCL  Keep _Operand() warning-free when no node in the family has operands
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+
+extern std::string cpp_BitsValue(Node *node, Attribute *a, const std::string &obj);
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_FlatOperand() -- Determine if an attribute holds an operand of a family (a child that is a family node)
+//-------------------------------------------------------------------------------------------------------------------
+static bool cpp_FlatOperand(Node *family, Attribute *a)
+{
+    return a->Is_Child() && GetNode(a->Get_Type())->Is_A(family);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_FlatAttrs() -- Get the operands and payload of a concrete node in a family, starting with the attributes of
+//                    the family root (the attributes of its ancestors are not part of the flattened form)
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_FlatAttrs(Node *family, Node *node, std::vector<Attribute *> &args, std::vector<Attribute *> &data,
+        std::vector<Node *> &owners)
+{
+    if (node != family) cpp_FlatAttrs(family, node->Get_Parent(), args, data, owners);
+
+    for (AttrList *al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        Attribute *a = al->elem();
+
+        if (cpp_FlatOperand(family, a)) args.push_back(a);
+        else if (!(a->Get_Flags() & (STATIC | COMPUTED | LAZY))) {
+            data.push_back(a);
+            owners.push_back(node);
+        }
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_FlatMaxArgs() -- Get the largest number of operands of any node in a family
+//-------------------------------------------------------------------------------------------------------------------
+static int cpp_FlatMaxArgs(Node *family)
+{
+    int rv = 0;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> args, data;
+        std::vector<Node *> owners;
+
+        if (!n->Is_A(family) || (n->Get_Flags() & ABSTRACT)) continue;
+
+        cpp_FlatAttrs(family, n, args, data, owners);
+        if ((int)args.size() > rv) rv = (int)args.size();
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitFlatValue() -- Emit the value of a payload attribute read from the node p
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitFlatValue(std::ofstream &os, Node *owner, Attribute *a)
+{
+    if (a->Get_Bits()) {
+        os << cpp_BitsValue(owner, a, "p->");
+    } else if (a->Get_Flags() & INTERNED) {
+        os << "ASTIntern<" << a->Get_Type()->Get_Name() << ">::Get(p->" << a->Get_Name() << ")";
+    } else os << "p->" << a->Get_Name();
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitFlatCall() -- Emit the call to the evaluator function for a concrete node
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitFlatCall(std::ofstream &os, Node *family, Node *n, const char *op)
+{
+    std::vector<Attribute *> args, data;
+    std::vector<Node *> owners;
+    std::string name = n->Get_Name()->Get_Name();
+    bool comma = false;
+
+    cpp_FlatAttrs(family, n, args, data, owners);
+
+    os << "e.Eval_" << name << "(";
+
+    if (!data.empty()) {
+        os << name << "_payload[" << op << "data]";
+        comma = true;
+    }
+
+    for (size_t i = 0; i < args.size(); i ++) {
+        os << (comma?", ":"") << "v[" << op << "arg[" << i << "]]";
+        comma = true;
+    }
+
+    os << ")";
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitFlatFamily() -- Emit the ASTFlat specialization for one family
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitFlatFamily(std::ofstream &os, Node *family)
+{
+    std::string root = family->Get_Name()->Get_Name();
+    int maxArgs = cpp_FlatMaxArgs(family);
+    std::string first;
+    NodeList *nl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        if (n->Is_A(family) && !(n->Get_Flags() & ABSTRACT)) {
+            first = "NODE_TYPE_" + n->Get_Name()->Get_Name();
+            break;
+        }
+    }
+
+    os << "template <>" << std::endl;
+    os << "class ASTFlat<" << root << "> {" << std::endl;
+
+    //
+    // -- The operations and their payloads
+    //    ---------------------------------
+    os << "public:" << std::endl;
+    os << "\tstatic const unsigned int MaxArgs = " << maxArgs << ";" << std::endl << std::endl;
+
+    os << "\tstruct Op {" << std::endl;
+    os << "\t\tASTNodeType tag;" << std::endl;
+    os << "\t\tunsigned int data;" << std::endl;
+    if (maxArgs) os << "\t\tunsigned int arg[" << maxArgs << "];" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> args, data;
+        std::vector<Node *> owners;
+
+        if (!n->Is_A(family) || (n->Get_Flags() & ABSTRACT)) continue;
+
+        cpp_FlatAttrs(family, n, args, data, owners);
+        if (data.empty()) continue;
+
+        os << "\tstruct " << n->Get_Name()->Get_Name() << "_Payload {" << std::endl;
+
+        for (size_t i = 0; i < data.size(); i ++) {
+            os << "\t\t" << data[i]->Get_Type()->Get_Name() << " " << (data[i]->Get_Type()->Get_Kind()==NODE?"*":"")
+                    << data[i]->Get_Name() << ";" << std::endl;
+        }
+
+        os << "\t};" << std::endl << std::endl;
+    }
+
+    os << "\tstd::vector<Op> ops;" << std::endl;
+    os << "\tstd::vector<const " << root << " *> nodes;" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> args, data;
+        std::vector<Node *> owners;
+
+        if (!n->Is_A(family) || (n->Get_Flags() & ABSTRACT)) continue;
+
+        cpp_FlatAttrs(family, n, args, data, owners);
+        if (data.empty()) continue;
+
+        os << "\tstd::vector<" << n->Get_Name()->Get_Name() << "_Payload> " << n->Get_Name()->Get_Name() << "_payload;"
+                << std::endl;
+    }
+
+    os << std::endl;
+
+    //
+    // -- Construction and reuse
+    //    ----------------------
+    os << "public:" << std::endl;
+    os << "\tASTFlat(void) {}" << std::endl;
+    os << "\texplicit ASTFlat(const " << root << " *tree) { Assign(tree); }" << std::endl << std::endl;
+
+    os << "\tsize_t Size(void) const { return ops.size(); }" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Empty the arrays, keeping their storage for the next tree" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tvoid Clear(void) {" << std::endl;
+    os << "\t\tops.clear();" << std::endl;
+    os << "\t\tnodes.clear();" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> args, data;
+        std::vector<Node *> owners;
+
+        if (!n->Is_A(family) || (n->Get_Flags() & ABSTRACT)) continue;
+
+        cpp_FlatAttrs(family, n, args, data, owners);
+        if (!data.empty()) os << "\t\t" << n->Get_Name()->Get_Name() << "_payload.clear();" << std::endl;
+    }
+
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- The flattening walk.  The operands of each node are pushed on the stack in turn; when they are all done,
+    //    their indexes are on the top of the done stack and the node's operation can be added.
+    //    -------------------------------------------------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Flatten a tree into postorder; a missing operand refers to index Size()" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tvoid Assign(const " << root << " *tree) {" << std::endl;
+    os << "\t\tstruct Frame { const " << root << " *n; unsigned int next; };" << std::endl;
+    os << "\t\tstd::vector<Frame> stack;" << std::endl;
+    os << "\t\tstd::vector<unsigned int> done;" << std::endl;
+    os << "\t\tconst " << root << " *c;" << std::endl << std::endl;
+
+    os << "\t\tClear();" << std::endl;
+    os << "\t\tif (!tree) return;" << std::endl;
+    os << "\t\tstack.push_back(Frame{ tree, 0 });" << std::endl << std::endl;
+
+    os << "\t\twhile (!stack.empty()) {" << std::endl;
+    os << "\t\t\tFrame &f = stack.back();" << std::endl << std::endl;
+
+    os << "\t\t\tif (_Operand(f.n, f.next, c)) {" << std::endl;
+    os << "\t\t\t\tf.next ++;" << std::endl;
+    os << "\t\t\t\tif (c) stack.push_back(Frame{ c, 0 });" << std::endl;
+    os << "\t\t\t\telse done.push_back(~0u);" << std::endl;
+    os << "\t\t\t\tcontinue;" << std::endl;
+    os << "\t\t\t}" << std::endl << std::endl;
+
+    os << "\t\t\tOp o;" << std::endl;
+    os << "\t\t\to.tag = f.n->_tag;" << std::endl;
+    os << "\t\t\to.data = _Payload(f.n);" << std::endl;
+
+    if (maxArgs) {
+        os << "\t\t\tfor (unsigned int i = 0; i < MaxArgs; i ++) "
+                "o.arg[i] = (i < f.next ? done[done.size() - f.next + i] : ~0u);" << std::endl;
+    }
+
+    os << "\t\t\tdone.resize(done.size() - f.next);" << std::endl;
+    os << "\t\t\tdone.push_back((unsigned int)ops.size());" << std::endl;
+    os << "\t\t\tops.push_back(o);" << std::endl;
+    os << "\t\t\tnodes.push_back(f.n);" << std::endl;
+    os << "\t\t\tstack.pop_back();" << std::endl;
+    os << "\t\t}" << std::endl;
+
+    if (maxArgs) {
+        os << std::endl;
+        os << "\t\tfor (size_t i = 0; i < ops.size(); i ++) {" << std::endl;
+        os << "\t\t\tfor (unsigned int j = 0; j < MaxArgs; j ++) "
+                "if (ops[i].arg[j] == ~0u) ops[i].arg[j] = (unsigned int)ops.size();" << std::endl;
+        os << "\t\t}" << std::endl;
+    }
+
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- The evaluator.  The values are kept in v, one per operation plus Value() for the missing operands.
+    //    ---------------------------------------------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Evaluate the operations in order, calling e.Eval_<node>(payload, operand values...)" << std::endl;
+    os << "\t//    for each; v holds the values and can be reused from one call to the next" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\ttemplate <class E>" << std::endl;
+    os << "\ttypename E::Value Eval(E &e, std::vector<typename E::Value> &v) const {" << std::endl;
+    os << "\t\tsize_t n = ops.size();" << std::endl << std::endl;
+
+    os << "\t\tif (n == 0) return typename E::Value();" << std::endl;
+    os << "\t\tv.resize(n + 1);" << std::endl;
+    os << "\t\tv[n] = typename E::Value();" << std::endl << std::endl;
+
+    os << "\t\tconst Op *o = &ops[0];" << std::endl;
+    os << "\t\tconst Op *end = o + n;" << std::endl;
+    os << "\t\ttypename E::Value *r = &v[0];" << std::endl << std::endl;
+
+    os << "#if defined(__GNUC__) && !defined(AST_FLAT_SWITCH)" << std::endl;
+    os << "\t\tstatic void *const labels[] = {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        if (!n->Is_A(family) || (n->Get_Flags() & ABSTRACT)) continue;
+        os << "\t\t\t&&L_" << n->Get_Name()->Get_Name() << "," << std::endl;
+    }
+
+    os << "\t\t};" << std::endl << std::endl;
+    os << "\t\tgoto *labels[o->tag - " << first << "];" << std::endl << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        if (!n->Is_A(family) || (n->Get_Flags() & ABSTRACT)) continue;
+
+        os << "\tL_" << n->Get_Name()->Get_Name() << ":" << std::endl;
+        os << "\t\t*r ++ = ";
+        cpp_EmitFlatCall(os, family, n, "o->");
+        os << ";" << std::endl;
+        os << "\t\tif (++ o == end) return v[n - 1];" << std::endl;
+        os << "\t\tgoto *labels[o->tag - " << first << "];" << std::endl;
+    }
+
+    os << "#else" << std::endl;
+    os << "\t\tfor ( ; o != end; ++ o, ++ r) {" << std::endl;
+    os << "\t\t\tswitch (o->tag) {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        if (!n->Is_A(family) || (n->Get_Flags() & ABSTRACT)) continue;
+
+        os << "\t\t\tcase NODE_TYPE_" << n->Get_Name()->Get_Name() << ": *r = ";
+        cpp_EmitFlatCall(os, family, n, "o->");
+        os << "; break;" << std::endl;
+    }
+
+    os << "\t\t\tdefault: break;" << std::endl;
+    os << "\t\t\t}" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\treturn v[n - 1];" << std::endl;
+    os << "#endif" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\ttemplate <class E>" << std::endl;
+    os << "\ttypename E::Value Eval(E &e) const { std::vector<typename E::Value> v; return Eval(e, v); }"
+            << std::endl << std::endl;
+
+    //
+    // -- Reach the operands of a node by index, and copy its payload
+    //    -----------------------------------------------------------
+    os << "private:" << std::endl;
+    os << "\tstatic bool _Operand(const " << root << " *n, unsigned int i, const " << root << " *&c) {" << std::endl;
+    os << "\t\t(void)i; (void)c;" << std::endl;            // -- unused when no node in the family has operands
+    os << "\t\tswitch (n->_tag) {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> args, data;
+        std::vector<Node *> owners;
+        std::string name = n->Get_Name()->Get_Name();
+
+        if (!n->Is_A(family) || (n->Get_Flags() & ABSTRACT)) continue;
+
+        cpp_FlatAttrs(family, n, args, data, owners);
+        if (args.empty()) continue;
+
+        os << "\t\tcase NODE_TYPE_" << name << ":" << std::endl;
+
+        for (size_t i = 0; i < args.size(); i ++) {
+            os << "\t\t\tif (i == " << i << ") { c = static_cast<const " << name << " *>(n)->" << args[i]->Get_Name()
+                    << "; return true; }" << std::endl;
+        }
+
+        os << "\t\t\treturn false;" << std::endl;
+    }
+
+    os << "\t\tdefault:" << std::endl;
+    os << "\t\t\treturn false;" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tunsigned int _Payload(const " << root << " *n) {" << std::endl;
+    os << "\t\tswitch (n->_tag) {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Attribute *> args, data;
+        std::vector<Node *> owners;
+        std::string name = n->Get_Name()->Get_Name();
+
+        if (!n->Is_A(family) || (n->Get_Flags() & ABSTRACT)) continue;
+
+        cpp_FlatAttrs(family, n, args, data, owners);
+        if (data.empty()) continue;
+
+        os << "\t\tcase NODE_TYPE_" << name << ": {" << std::endl;
+        os << "\t\t\tconst " << name << " *p = static_cast<const " << name << " *>(n);" << std::endl;
+        os << "\t\t\t" << name << "_payload.push_back(" << name << "_Payload{ ";
+
+        for (size_t i = 0; i < data.size(); i ++) {
+            os << (i?", ":"");
+            cpp_EmitFlatValue(os, owners[i], data[i]);
+        }
+
+        os << " });" << std::endl;
+        os << "\t\t\treturn (unsigned int)(" << name << "_payload.size() - 1);" << std::endl;
+        os << "\t\t}" << std::endl;
+    }
+
+    os << "\t\tdefault:" << std::endl;
+    os << "\t\t\treturn 0;" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "inline ASTFlat<" << root << "> " << root << "::Flatten(void) const { return ASTFlat<" << root
+            << ">(this); }" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitFlatten() -- Emit the flattened form of each family
+//
+// The labels as values in the evaluator are a GNU extension, which is why the pedantic warnings are turned off
+// around the classes.  Define AST_FLAT_SWITCH to use the switch instead.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitFlatten(std::ofstream &os)
+{
+    if (!HasFlatNodes()) return;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The flattened form of the node families, as operations in postorder" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "#if defined(__GNUC__)" << std::endl;
+    os << "#pragma GCC diagnostic push" << std::endl;
+    os << "#pragma GCC diagnostic ignored \"-Wpedantic\"" << std::endl;
+    os << "#endif" << std::endl << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        if (nl->elem()->Get_Flags() & FLATTEN) cpp_EmitFlatFamily(os, nl->elem());
+    }
+
+    os << "#if defined(__GNUC__)" << std::endl;
+    os << "#pragma GCC diagnostic pop" << std::endl;
+    os << "#endif" << std::endl;
+    os << std::endl << std::endl;
+}
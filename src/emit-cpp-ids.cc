@@ -0,0 +1,187 @@
+//===================================================================================================================
+// emit-cpp-ids.cc -- This file is responsible for emitting the CPP node ids and the side tables indexed by them
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// With the --ids option, every node gets a small number when it is constructed, counting up from 0.  A pass that
+// keeps something for each node can then keep it in an ASTSideTable, which is an array indexed by the id, rather
+// than in a hash map keyed by the node's address.
+//
+// The ids are handed out to each thread in blocks, so numbering a node is a thread-local increment except once per
+// block.  The numbering is dense when the nodes are built by one thread; with several, each thread leaves at most
+// the unused part of its last block.  There is one numbering for the whole program, shared by all of its trees;
+// ASTIds::Reset() starts it over.  ASTIds::Count() is the number of ids handed out, while ASTIds::Bound() is more
+// than every id handed out (it counts the unused parts of the blocks too), which is what a side table is sized by.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+// 2026-10-18    N/A    v0.1.1   ADCL  Count only the ids handed out, and size the side tables by ASTIds::Bound()
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitIds() -- Emit the id counter (--ids only), which the root node uses to number itself
+//
+// A reset bumps the epoch, which makes every thread drop what is left of its block the next time it numbers a
+// node.  No node may be constructed (on any thread) while the numbering is reset.  Each thread's block is listed in
+// the shared state so that Count() can take off the parts that are not handed out yet; a thread that ends leaves
+// what is left of its block as unused.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitIds(std::ofstream &os)
+{
+    if (!(options & OPT_IDS)) return;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTIds -- number the nodes densely as they are constructed" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "struct ASTIds {" << std::endl;
+    os << "\tenum { BLOCK = 1024 };" << std::endl << std::endl;
+
+    os << "\tstatic unsigned int Next(void) {" << std::endl;
+    os << "\t\tRange &r = Local();" << std::endl;
+    os << "\t\tunsigned int e = Shared().epoch.load(std::memory_order_acquire);" << std::endl;
+    os << "\t\tunsigned int n = r.next.load(std::memory_order_relaxed);" << std::endl << std::endl;
+    os << "\t\tif (n == r.end.load(std::memory_order_relaxed) || r.epoch.load(std::memory_order_relaxed) != e) {"
+            << std::endl;
+    os << "\t\t\tn = Shared().next.fetch_add(BLOCK, std::memory_order_relaxed);" << std::endl;
+    os << "\t\t\tr.end.store(n + BLOCK, std::memory_order_relaxed);" << std::endl;
+    os << "\t\t\tr.epoch.store(e, std::memory_order_relaxed);" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tr.next.store(n + 1, std::memory_order_relaxed);" << std::endl;
+    os << "\t\treturn n;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The number of ids handed out since the last reset (exact when no node is being built)" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic unsigned int Count(void) {" << std::endl;
+    os << "\t\tState &s = Shared();" << std::endl;
+    os << "\t\tstd::lock_guard<std::mutex> lock(s.mutex);" << std::endl;
+    os << "\t\tunsigned int e = s.epoch.load(std::memory_order_acquire);" << std::endl;
+    os << "\t\tunsigned int rv = s.next.load(std::memory_order_acquire) - s.unused;" << std::endl << std::endl;
+    os << "\t\tfor (Range *r = s.ranges; r; r = r->link) {" << std::endl;
+    os << "\t\t\tif (r->epoch.load(std::memory_order_relaxed) == e) rv -= r->end.load(std::memory_order_relaxed) - "
+            "r->next.load(std::memory_order_relaxed);" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\treturn rv;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Every id handed out so far is less than Bound()" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic unsigned int Bound(void) { return Shared().next.load(std::memory_order_acquire); }" << std::endl;
+    os << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Start the numbering over; no node may be constructed while this runs" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic void Reset(void) {" << std::endl;
+    os << "\t\tState &s = Shared();" << std::endl;
+    os << "\t\tstd::lock_guard<std::mutex> lock(s.mutex);" << std::endl << std::endl;
+    os << "\t\ts.next.store(0, std::memory_order_relaxed);" << std::endl;
+    os << "\t\ts.unused = 0;" << std::endl;
+    os << "\t\ts.epoch.fetch_add(1, std::memory_order_release);" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "private:" << std::endl;
+    os << "\tstruct Range {" << std::endl;
+    os << "\t\tstd::atomic<unsigned int> epoch, next, end;" << std::endl;
+    os << "\t\tRange *link;" << std::endl << std::endl;
+    os << "\t\tRange(void) : epoch(~0u), next(0), end(0), link(NULL) {" << std::endl;
+    os << "\t\t\tState &s = Shared();" << std::endl;
+    os << "\t\t\tstd::lock_guard<std::mutex> lock(s.mutex);" << std::endl << std::endl;
+    os << "\t\t\tlink = s.ranges;" << std::endl;
+    os << "\t\t\ts.ranges = this;" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\t~Range() {" << std::endl;
+    os << "\t\t\tState &s = Shared();" << std::endl;
+    os << "\t\t\tstd::lock_guard<std::mutex> lock(s.mutex);" << std::endl << std::endl;
+    os << "\t\t\tif (epoch.load() == s.epoch.load()) s.unused += end.load() - next.load();" << std::endl;
+    os << "\t\t\tfor (Range **p = &s.ranges; *p; p = &(*p)->link) {" << std::endl;
+    os << "\t\t\t\tif (*p == this) { *p = link; break; }" << std::endl;
+    os << "\t\t\t}" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    os << "\tstruct State {" << std::endl;
+    os << "\t\tstd::atomic<unsigned int> next;" << std::endl;
+    os << "\t\tstd::atomic<unsigned int> epoch;" << std::endl;
+    os << "\t\tstd::mutex mutex;" << std::endl;
+    os << "\t\tRange *ranges;" << std::endl;
+    os << "\t\tunsigned int unused;" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    os << "\tstatic Range &Local(void) { static thread_local Range r; return r; }" << std::endl;
+    os << "\tstatic State &Shared(void) { static State s; return s; }" << std::endl;
+    os << "};" << std::endl;
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitSideTable() -- Emit the side table template (--ids only)
+//
+// operator[] grows the table as needed, so it is for one thread at a time.  Prepare() sizes the table for every
+// node numbered so far; after that, At() is a plain array access that any number of threads can make at once (for
+// different nodes).  The values are kept in a std::vector, so use char rather than bool for flags.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitSideTable(std::ofstream &os)
+{
+    if (!(options & OPT_IDS)) return;
+
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTSideTable -- a value for each node, indexed by the node id" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class T>" << std::endl;
+    os << "class ASTSideTable {" << std::endl;
+    os << "private:" << std::endl;
+    os << "\tstd::vector<T> vals;" << std::endl;
+    os << "\tT fill;" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\texplicit ASTSideTable(const T &f = T()) : fill(f) { }" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tvoid Prepare(void) { if (vals.size() < ASTIds::Bound()) vals.resize(ASTIds::Bound(), fill); }" << std::endl;
+    os << "\tvoid Clear(void) { vals.clear(); }" << std::endl;
+    os << "\tsize_t Size(void) const { return vals.size(); }" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tT &operator[](const " << root << " *n) {" << std::endl;
+    os << "\t\tif (n->_GetId() >= vals.size()) vals.resize(n->_GetId() < ASTIds::Bound() ? ASTIds::Bound() : "
+            "n->_GetId() + 1, fill);" << std::endl;
+    os << "\t\treturn vals[n->_GetId()];" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tT &At(const " << root << " *n) { return vals[n->_GetId()]; }" << std::endl;
+    os << "\tconst T &At(const " << root << " *n) const { return vals[n->_GetId()]; }" << std::endl;
+    os << "};" << std::endl;
+    os << std::endl << std::endl;
+}
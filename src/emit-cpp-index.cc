@@ -0,0 +1,194 @@
+//===================================================================================================================
+// emit-cpp-index.cc -- This file is responsible for emitting the CPP index of the nodes by node type
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// With the --index option, the Factory() and with_ functions register each new node with the ASTIndex that is in
+// use on the thread, if any.  An index is meant to be used for one tree (or one compilation unit): it is put in
+// use with an ASTIndex::Scope while the tree is built, and then it can answer "all the Div nodes" or "all the
+// nodes derived from Expression" without walking the tree.
+//
+// The index keeps a list of the nodes of each node type, which answers a query for a concrete node directly.  It
+// also keeps the node type tags of all the nodes in one array, in the order they were registered, next to an array
+// of the nodes.  A query for a range of node type tags (an abstract node, since the tags are numbered in preorder
+// of the hierarchy) scans the tag array with SSE2 compares, 16 or 8 tags at a time.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitIndexScan() -- Emit the SSE2 loop of the tag scan, for tags of 1 or 2 bytes
+//
+// A tag t is in [first, last) when (t - first), as an unsigned number of the width of the tags, is at most
+// last - first - 1; SSE2 has no unsigned compare, but a saturating subtract of that limit gives 0 exactly then.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitIndexScan(std::ofstream &os, bool wide)
+{
+    const char *w = (wide ? "16" : "8");
+    int step = (wide ? 8 : 16);
+
+    os << "#if defined(__SSE2__) && defined(__GNUC__) && !defined(AST_INDEX_SCALAR)" << std::endl;
+    os << "\t\tconst __m128i vlo = _mm_set1_epi" << w << "((" << (wide ? "short" : "char") << ")lo);" << std::endl;
+    os << "\t\tconst __m128i vlim = _mm_set1_epi" << w << "((" << (wide ? "short" : "char") << ")lim);" << std::endl;
+    os << "\t\tconst __m128i zero = _mm_setzero_si128();" << std::endl << std::endl;
+
+    os << "\t\tfor ( ; i + " << step << " <= n; i += " << step << ") {" << std::endl;
+    os << "\t\t\t__m128i d = _mm_sub_epi" << w << "(_mm_loadu_si128((const __m128i *)(t + i)), vlo);" << std::endl;
+    os << "\t\t\tunsigned int m = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi" << w << "(_mm_subs_epu" << w
+            << "(d, vlim), zero))" << (wide ? " & 0x5555u" : "") << ";" << std::endl << std::endl;
+    os << "\t\t\twhile (m) { out.push_back(all[i + " << (wide ? "(__builtin_ctz(m) >> 1)" : "__builtin_ctz(m)")
+            << "]); m &= m - 1; }" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "#endif" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitIndex() -- Emit the node index (--index only), which the Factory() functions register the nodes with
+//
+// The tags are kept in a byte each when there are no more than 256 concrete nodes, and in 2 bytes otherwise.  The
+// index does not know when a node is deleted, so a tree's nodes must be deleted after its index is cleared (or
+// not queried again).
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitIndex(std::ofstream &os)
+{
+    if (!(options & OPT_INDEX)) return;
+
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+    int kinds = 0;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        if (!(nl->elem()->Get_Flags() & ABSTRACT)) kinds ++;
+    }
+
+    bool wide = (kinds > 256);
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTIndex -- the nodes of a tree by node type, registered as they are built" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "class ASTIndex {" << std::endl;
+    os << "public:" << std::endl;
+    os << "\tenum { KINDS = " << kinds << " };" << std::endl;
+    os << "\ttypedef unsigned " << (wide ? "short" : "char") << " Tag;" << std::endl << std::endl;
+
+    os << "private:" << std::endl;
+    os << "\tstd::vector<Tag> tags;" << std::endl;
+    os << "\tstd::vector<" << root << " *> all;" << std::endl;
+    os << "\tstd::vector<" << root << " *> kinds[KINDS];" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tASTIndex(void) { }" << std::endl;
+    os << "\tASTIndex(const ASTIndex &) = delete;" << std::endl;
+    os << "\tASTIndex &operator=(const ASTIndex &) = delete;" << std::endl << std::endl;
+
+    //
+    // -- the index in use on this thread, which is set for the life of a Scope
+    //    ---------------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The index the new nodes are registered with on this thread; NULL for none" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic ASTIndex *&Current(void) { static thread_local ASTIndex *c = NULL; return c; }" << std::endl
+            << std::endl;
+
+    os << "\tstruct Scope {" << std::endl;
+    os << "\t\tASTIndex *prev;" << std::endl;
+    os << "\t\texplicit Scope(ASTIndex &i) : prev(Current()) { Current() = &i; }" << std::endl;
+    os << "\t\t~Scope(void) { Current() = prev; }" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    os << "\tstatic void Register(" << root << " *n, ASTNodeType t) { ASTIndex *c = Current(); if (c) c->Add(n, t); }"
+            << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tvoid Add(" << root << " *n, ASTNodeType t) { tags.push_back((Tag)t); all.push_back(n); "
+            "kinds[t].push_back(n); }" << std::endl;
+    os << "\tvoid Clear(void) { tags.clear(); all.clear(); for (int k = 0; k < KINDS; k ++) kinds[k].clear(); }"
+            << std::endl;
+    os << "\tsize_t Size(void) const { return all.size(); }" << std::endl << std::endl;
+
+    //
+    // -- the queries: an exact node type is a list already; a range scans the tags
+    //    -------------------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The nodes of one node type, in the order they were built" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tconst std::vector<" << root << " *> &Of(ASTNodeType t) const { return kinds[t]; }" << std::endl
+            << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The number of nodes with a tag in [first, last)" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tsize_t Count(int first, int last) const {" << std::endl;
+    os << "\t\tsize_t rv = 0;" << std::endl;
+    os << "\t\tfor (int k = first; k < last; k ++) rv += kinds[k].size();" << std::endl;
+    os << "\t\treturn rv;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Append the nodes with a tag in [first, last) to out, in the order they were built" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tvoid Range(int first, int last, std::vector<" << root << " *> &out) const {" << std::endl;
+    os << "\t\tif (first >= last) return;" << std::endl;
+    os << "\t\tif (last - first == 1) { out.insert(out.end(), kinds[first].begin(), kinds[first].end()); return; }"
+            << std::endl << std::endl;
+
+    os << "\t\tconst Tag *t = tags.data();" << std::endl;
+    os << "\t\tconst Tag lo = (Tag)first;" << std::endl;
+    os << "\t\tconst Tag lim = (Tag)(last - first - 1);" << std::endl;
+    os << "\t\tsize_t n = tags.size();" << std::endl;
+    os << "\t\tsize_t i = 0;" << std::endl << std::endl;
+
+    os << "\t\tout.reserve(out.size() + Count(first, last));" << std::endl << std::endl;
+
+    cpp_EmitIndexScan(os, wide);
+
+    os << "\t\tfor ( ; i < n; i ++) if ((Tag)(t[i] - lo) <= lim) out.push_back(all[i]);" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the typed queries use the tag ranges from the reflection tables
+    //    ---------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The nodes that are a T (T may be abstract), in the order they were built" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\ttemplate <class T> size_t Count(void) const { return Count(ASTReflect<T>::first, ASTReflect<T>::last); }"
+            << std::endl << std::endl;
+
+    os << "\ttemplate <class T> std::vector<T *> All(void) const {" << std::endl;
+    os << "\t\tstd::vector<" << root << " *> found;" << std::endl;
+    os << "\t\tstd::vector<T *> rv;" << std::endl << std::endl;
+    os << "\t\tRange(ASTReflect<T>::first, ASTReflect<T>::last, found);" << std::endl;
+    os << "\t\trv.reserve(found.size());" << std::endl;
+    os << "\t\tfor (size_t i = 0; i < found.size(); i ++) rv.push_back(static_cast<T *>(found[i]));" << std::endl;
+    os << "\t\treturn rv;" << std::endl;
+    os << "\t}" << std::endl;
+    os << "};" << std::endl;
+    os << std::endl << std::endl;
+}
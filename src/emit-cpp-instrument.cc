@@ -0,0 +1,482 @@
+//===================================================================================================================
+// emit-cpp-instrument.cc -- This file is responsible for emitting the CPP instrumentation support
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// The instrumentation is emitted only when it is requested on the command line, and even then it is compiled
+// out of the generated header unless the user defines the matching macro.  The nodes only ever reference the
+// instrumentation through the AST_STATS_* and AST_TRACE_* macros, which expand to nothing when it is compiled out.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the method tracing
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitStats() -- Emit the per-node-type allocation counters (--stats only)
+//
+// Each thread counts into its own block, so counting is a plain load and store with no lock and no contended
+// cache line.  The blocks are pushed onto a lock-free list the first time a thread counts anything and are never
+// freed, so that ASTStats::Report() can total the counts of threads that have already ended.  A node that is
+// destroyed on a different thread than it was created on leaves the live counts of the two threads off by one
+// in opposite directions; the totals are still right.
+//
+// The sizes are not known until the classes are complete, so Name() and Size() are defined later by
+// cpp_EmitStatsTables().
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitStats(std::ofstream &os)
+{
+    if (!(options & OPT_STATS)) return;
+
+    NodeList *nl;
+    int count = 0;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        if (!(nl->elem()->Get_Flags() & ABSTRACT)) count ++;
+    }
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTStats -- per-node-type allocation counters; define AST_STATS to compile them in" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "#ifdef AST_STATS" << std::endl;
+    os << "#include <atomic>" << std::endl;
+    os << "#include <cstdio>" << std::endl;
+    os << "#include <algorithm>" << std::endl << std::endl;
+
+    os << "struct ASTStats {" << std::endl;
+    os << "\tenum { TYPES = " << count << " };" << std::endl << std::endl;
+
+    os << "\tstruct Block {" << std::endl;
+    os << "\t\tstd::atomic<long> live[TYPES];" << std::endl;
+    os << "\t\tstd::atomic<long> created[TYPES];" << std::endl;
+    os << "\t\tstd::atomic<long> bytes[TYPES];" << std::endl;
+    os << "\t\tBlock *next;" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    //
+    // -- the registry of the per-thread blocks
+    //    -------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The blocks of all the threads that have counted anything" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic std::atomic<Block *> &Blocks(void) {" << std::endl;
+    os << "\t\tstatic std::atomic<Block *> head(NULL);" << std::endl;
+    os << "\t\treturn head;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstatic Block *Register(void) {" << std::endl;
+    os << "\t\tBlock *b = new Block;" << std::endl << std::endl;
+    os << "\t\tfor (int i = 0; i < TYPES; i ++) {" << std::endl;
+    os << "\t\t\tb->live[i].store(0, std::memory_order_relaxed);" << std::endl;
+    os << "\t\t\tb->created[i].store(0, std::memory_order_relaxed);" << std::endl;
+    os << "\t\t\tb->bytes[i].store(0, std::memory_order_relaxed);" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tb->next = Blocks().load(std::memory_order_relaxed);" << std::endl;
+    os << "\t\twhile (!Blocks().compare_exchange_weak(b->next, b, std::memory_order_release,"
+            << " std::memory_order_relaxed)) { }" << std::endl << std::endl;
+    os << "\t\treturn b;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstatic Block &Local(void) {" << std::endl;
+    os << "\t\tstatic thread_local Block *b = Register();" << std::endl;
+    os << "\t\treturn *b;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- only the owning thread writes to a block, so there is no need for a locked add
+    //    ------------------------------------------------------------------------------
+    os << "\tstatic void Bump(std::atomic<long> &c, long d) {" << std::endl;
+    os << "\t\tc.store(c.load(std::memory_order_relaxed) + d, std::memory_order_relaxed);" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the counting interface
+    //    ----------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Count a node of type t being created or destroyed" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic const char *Name(int t);" << std::endl;
+    os << "\tstatic long Size(int t);" << std::endl << std::endl;
+
+    os << "\tstatic void Created(ASTNodeType t) {" << std::endl;
+    os << "\t\tBlock &b = Local();" << std::endl << std::endl;
+    os << "\t\tBump(b.live[t], 1);" << std::endl;
+    os << "\t\tBump(b.created[t], 1);" << std::endl;
+    os << "\t\tBump(b.bytes[t], Size(t));" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstatic void Destroyed(ASTNodeType t) {" << std::endl;
+    os << "\t\tBlock &b = Local();" << std::endl << std::endl;
+    os << "\t\tBump(b.live[t], -1);" << std::endl;
+    os << "\t\tBump(b.bytes[t], -Size(t));" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the report
+    //    ----------
+    os << "\t//" << std::endl;
+    os << "\t// -- Print the totals of all threads, sorted by the bytes that are still live" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic void Report(FILE *f = stderr) {" << std::endl;
+    os << "\t\tlong live[TYPES] = { 0 }, created[TYPES] = { 0 }, bytes[TYPES] = { 0 };" << std::endl;
+    os << "\t\tlong totLive = 0, totCreated = 0, totBytes = 0;" << std::endl;
+    os << "\t\tint order[TYPES];" << std::endl << std::endl;
+    os << "\t\tfor (Block *b = Blocks().load(std::memory_order_acquire); b; b = b->next) {" << std::endl;
+    os << "\t\t\tfor (int i = 0; i < TYPES; i ++) {" << std::endl;
+    os << "\t\t\t\tlive[i] += b->live[i].load(std::memory_order_relaxed);" << std::endl;
+    os << "\t\t\t\tcreated[i] += b->created[i].load(std::memory_order_relaxed);" << std::endl;
+    os << "\t\t\t\tbytes[i] += b->bytes[i].load(std::memory_order_relaxed);" << std::endl;
+    os << "\t\t\t}" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tfor (int i = 0; i < TYPES; i ++) order[i] = i;" << std::endl;
+    os << "\t\tstd::stable_sort(order, order + TYPES, [&bytes](int a, int b) { return bytes[a] > bytes[b]; });"
+            << std::endl << std::endl;
+    os << "\t\tfprintf(f, \"%-24s %12s %12s %14s %6s\\n\", \"node type\", \"live\", \"created\", \"bytes\", \"%\");"
+            << std::endl;
+    os << "\t\tfor (int i = 0; i < TYPES; i ++) totBytes += bytes[i];" << std::endl << std::endl;
+    os << "\t\tfor (int i = 0; i < TYPES; i ++) {" << std::endl;
+    os << "\t\t\tint t = order[i];" << std::endl << std::endl;
+    os << "\t\t\tif (!created[t]) continue;" << std::endl;
+    os << "\t\t\tfprintf(f, \"%-24s %12ld %12ld %14ld %5.1f%%\\n\", Name(t), live[t], created[t], bytes[t],"
+            << std::endl;
+    os << "\t\t\t\t\ttotBytes ? 100.0 * bytes[t] / totBytes : 0.0);" << std::endl;
+    os << "\t\t\ttotLive += live[t];" << std::endl;
+    os << "\t\t\ttotCreated += created[t];" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tfprintf(f, \"%-24s %12ld %12ld %14ld\\n\", \"total\", totLive, totCreated, totBytes);" << std::endl;
+    os << "\t}" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "#define AST_STATS_CREATED(t) ASTStats::Created(t)" << std::endl;
+    os << "#define AST_STATS_DESTROYED(t) ASTStats::Destroyed(t)" << std::endl;
+    os << "#else" << std::endl;
+    os << "#define AST_STATS_CREATED(t)" << std::endl;
+    os << "#define AST_STATS_DESTROYED(t)" << std::endl;
+    os << "#endif" << std::endl;
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitStatsTables() -- Emit the node type names and sizes for the allocation counters (--stats only)
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitStatsTables(std::ofstream &os)
+{
+    if (!(options & OPT_STATS)) return;
+
+    NodeList *nl;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The names and sizes of the node types for ASTStats" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "#ifdef AST_STATS" << std::endl;
+    os << "inline const char *ASTStats::Name(int t) {" << std::endl;
+    os << "\tstatic const char *names[] = {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+        os << "\t\t\"" << n->Get_Name()->Get_Name() << "\"," << std::endl;
+    }
+
+    os << "\t};" << std::endl << std::endl;
+    os << "\treturn names[t];" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline long ASTStats::Size(int t) {" << std::endl;
+    os << "\tstatic const long sizes[] = {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+        os << "\t\t(long)sizeof(" << n->Get_Name()->Get_Name() << ")," << std::endl;
+    }
+
+    os << "\t};" << std::endl << std::endl;
+    os << "\treturn sizes[t];" << std::endl;
+    os << "}" << std::endl;
+    os << "#endif" << std::endl;
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_IsTraced() -- Determine if a method is traced; only the methods with their code in the source are
+//-------------------------------------------------------------------------------------------------------------------
+bool cpp_IsTraced(Method *m)
+{
+    return !(m->Get_Flags() & (ABSTRACT | EXTERNAL));
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_TraceId() -- Get the name of the trace id for a method; overloads after the first are numbered
+//-------------------------------------------------------------------------------------------------------------------
+std::string cpp_TraceId(Node *node, Method *m)
+{
+    MethList *ml;
+    int overload = 0;
+    char buf[16];
+
+    for (ml = First(node->Get_Meths()); More(ml) && ml->elem() != m; ml = Next(ml)) {
+        if (ml->elem()->Get_Name() == m->Get_Name()) overload ++;
+    }
+
+    std::string rv = "AST_METH_" + node->Get_Name()->Get_Name() + "_" + m->Get_Name();
+
+    if (overload) {
+        sprintf(buf, "_%d", overload + 1);
+        rv += buf;
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitTrace() -- Emit the method tracing support (--trace only)
+//
+// Every traced method opens an ASTTrace::Scope, which writes an enter event when it is constructed and an exit
+// event when it is destroyed.  An event is the timestamp (the TSC where there is one), the node type (-1 for a
+// static method) and the method id.  The events go into a ring buffer owned by the calling thread, so recording
+// one is a handful of plain stores; the oldest events are overwritten when the ring wraps.
+//
+// ASTTrace::Report() rebuilds the call stacks from the events that are still in the rings to total the calls,
+// the self time and the total time of each method.  It reads the rings of all the threads, so it must only be
+// called while no other thread is running traced methods.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitTrace(std::ofstream &os)
+{
+    if (!(options & OPT_TRACE)) return;
+
+    NodeList *nl;
+    MethList *ml;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The ids of the traced methods" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "typedef enum {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        for (ml = First(nl->elem()->Get_Meths()); More(ml); ml = Next(ml)) {
+            if (!cpp_IsTraced(ml->elem())) continue;
+            os << "\t" << cpp_TraceId(nl->elem(), ml->elem()) << "," << std::endl;
+        }
+    }
+
+    os << "\tAST_METH_COUNT" << std::endl;
+    os << "} ASTMethodId;" << std::endl << std::endl;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTTrace -- per-thread ring buffers of method calls; define AST_TRACE to compile them in" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "#ifdef AST_TRACE" << std::endl;
+    os << "#include <atomic>" << std::endl;
+    os << "#include <cstdio>" << std::endl;
+    os << "#include <cstdint>" << std::endl;
+    os << "#include <algorithm>" << std::endl;
+    os << "#if defined(__x86_64__) || defined(__i386__)" << std::endl;
+    os << "#include <x86intrin.h>" << std::endl;
+    os << "#else" << std::endl;
+    os << "#include <chrono>" << std::endl;
+    os << "#endif" << std::endl << std::endl;
+
+    os << "#ifndef AST_TRACE_RING" << std::endl;
+    os << "#define AST_TRACE_RING 65536" << std::endl;
+    os << "#endif" << std::endl << std::endl;
+
+    os << "struct ASTTrace {" << std::endl;
+    os << "\tenum { SIZE = AST_TRACE_RING };" << std::endl;
+    os << "\tstatic_assert((SIZE & (SIZE - 1)) == 0, \"AST_TRACE_RING must be a power of 2\");" << std::endl << std::endl;
+
+    os << "\tstatic const uint32_t EXIT = 0x80000000u;" << std::endl << std::endl;
+
+    os << "\tstruct Event {" << std::endl;
+    os << "\t\tuint64_t tsc;" << std::endl;
+    os << "\t\tint32_t type;" << std::endl;
+    os << "\t\tuint32_t meth;" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    os << "\tstruct Ring {" << std::endl;
+    os << "\t\tEvent events[SIZE];" << std::endl;
+    os << "\t\tuint64_t head;" << std::endl;
+    os << "\t\tRing *next;" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    //
+    // -- the clock
+    //    ---------
+    os << "\t//" << std::endl;
+    os << "\t// -- Read the clock; the TSC where there is one, otherwise nanoseconds" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic uint64_t Now(void) {" << std::endl;
+    os << "#if defined(__x86_64__) || defined(__i386__)" << std::endl;
+    os << "\t\treturn __rdtsc();" << std::endl;
+    os << "#else" << std::endl;
+    os << "\t\treturn std::chrono::duration_cast<std::chrono::nanoseconds>(" << std::endl;
+    os << "\t\t\t\tstd::chrono::steady_clock::now().time_since_epoch()).count();" << std::endl;
+    os << "#endif" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the registry of the per-thread rings
+    //    ------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The rings of all the threads that have traced anything" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic std::atomic<Ring *> &Rings(void) {" << std::endl;
+    os << "\t\tstatic std::atomic<Ring *> head(NULL);" << std::endl;
+    os << "\t\treturn head;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstatic Ring *Register(void) {" << std::endl;
+    os << "\t\tRing *r = new Ring;" << std::endl << std::endl;
+    os << "\t\tr->head = 0;" << std::endl;
+    os << "\t\tr->next = Rings().load(std::memory_order_relaxed);" << std::endl;
+    os << "\t\twhile (!Rings().compare_exchange_weak(r->next, r, std::memory_order_release,"
+            << " std::memory_order_relaxed)) { }" << std::endl << std::endl;
+    os << "\t\treturn r;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstatic Ring &Local(void) {" << std::endl;
+    os << "\t\tstatic thread_local Ring *r = Register();" << std::endl;
+    os << "\t\treturn *r;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstatic void Record(Ring &r, int32_t type, uint32_t meth) {" << std::endl;
+    os << "\t\tEvent &e = r.events[r.head ++ & (SIZE - 1)];" << std::endl << std::endl;
+    os << "\t\te.tsc = Now();" << std::endl;
+    os << "\t\te.type = type;" << std::endl;
+    os << "\t\te.meth = meth;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the scoped hook
+    //    ---------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The hook that traces the enter and exit of a method" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tclass Scope {" << std::endl;
+    os << "\t\tRing &ring;" << std::endl;
+    os << "\t\tint32_t type;" << std::endl;
+    os << "\t\tuint32_t meth;" << std::endl << std::endl;
+    os << "\tpublic:" << std::endl;
+    os << "\t\tScope(int32_t t, uint32_t m) : ring(Local()), type(t), meth(m) { Record(ring, type, meth); }" << std::endl;
+    os << "\t\t~Scope(void) { Record(ring, type, meth | EXIT); }" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    //
+    // -- the report
+    //    ----------
+    os << "\tstatic const char *Name(int m);" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Print the calls, self time and total time of each method, sorted by self time" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic void Report(FILE *f = stderr) {" << std::endl;
+    os << "\t\tstruct Frame { uint32_t meth; uint64_t start; uint64_t child; };" << std::endl;
+    os << "\t\tlong calls[AST_METH_COUNT + 1] = { 0 };" << std::endl;
+    os << "\t\tuint64_t self[AST_METH_COUNT + 1] = { 0 }, total[AST_METH_COUNT + 1] = { 0 };" << std::endl;
+    os << "\t\tint order[AST_METH_COUNT + 1];" << std::endl << std::endl;
+    os << "\t\tfor (Ring *r = Rings().load(std::memory_order_acquire); r; r = r->next) {" << std::endl;
+    os << "\t\t\tstd::vector<Frame> stack;" << std::endl;
+    os << "\t\t\tuint64_t i = (r->head > (uint64_t)SIZE ? r->head - SIZE : 0);" << std::endl << std::endl;
+    os << "\t\t\tfor ( ; i < r->head; i ++) {" << std::endl;
+    os << "\t\t\t\tconst Event &e = r->events[i & (SIZE - 1)];" << std::endl << std::endl;
+    os << "\t\t\t\tif (!(e.meth & EXIT)) {" << std::endl;
+    os << "\t\t\t\t\tFrame fr = { e.meth, e.tsc, 0 };" << std::endl;
+    os << "\t\t\t\t\tstack.push_back(fr);" << std::endl;
+    os << "\t\t\t\t\tcontinue;" << std::endl;
+    os << "\t\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\t\t// -- an exit whose enter was overwritten is dropped" << std::endl;
+    os << "\t\t\t\tif (stack.empty() || stack.back().meth != (e.meth & ~EXIT)) continue;" << std::endl << std::endl;
+    os << "\t\t\t\tFrame fr = stack.back();" << std::endl;
+    os << "\t\t\t\tuint64_t elapsed = e.tsc - fr.start;" << std::endl << std::endl;
+    os << "\t\t\t\tstack.pop_back();" << std::endl;
+    os << "\t\t\t\tcalls[fr.meth] ++;" << std::endl;
+    os << "\t\t\t\tself[fr.meth] += elapsed - fr.child;" << std::endl;
+    os << "\t\t\t\ttotal[fr.meth] += elapsed;" << std::endl;
+    os << "\t\t\t\tif (!stack.empty()) stack.back().child += elapsed;" << std::endl;
+    os << "\t\t\t}" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tfor (int i = 0; i < AST_METH_COUNT; i ++) order[i] = i;" << std::endl;
+    os << "\t\tstd::stable_sort(order, order + AST_METH_COUNT, [&self](int a, int b) { return self[a] > self[b]; });"
+            << std::endl << std::endl;
+    os << "\t\tfprintf(f, \"%-32s %12s %16s %16s\\n\", \"method\", \"calls\", \"self\", \"total\");" << std::endl;
+    os << "\t\tfor (int i = 0; i < AST_METH_COUNT; i ++) {" << std::endl;
+    os << "\t\t\tint m = order[i];" << std::endl << std::endl;
+    os << "\t\t\tif (!calls[m]) continue;" << std::endl;
+    os << "\t\t\tfprintf(f, \"%-32s %12ld %16llu %16llu\\n\", Name(m), calls[m], (unsigned long long)self[m],"
+            << std::endl;
+    os << "\t\t\t\t\t(unsigned long long)total[m]);" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "#define AST_TRACE_SCOPE(t, m) ASTTrace::Scope _astTraceScope((t), (m))" << std::endl;
+    os << "#else" << std::endl;
+    os << "#define AST_TRACE_SCOPE(t, m) do { } while (0)" << std::endl;
+    os << "#endif" << std::endl;
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitTraceTables() -- Emit the names of the traced methods (--trace only)
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitTraceTables(std::ofstream &os)
+{
+    if (!(options & OPT_TRACE)) return;
+
+    NodeList *nl;
+    MethList *ml;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The names of the traced methods for ASTTrace" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "#ifdef AST_TRACE" << std::endl;
+    os << "inline const char *ASTTrace::Name(int m) {" << std::endl;
+    os << "\tstatic const char *names[] = {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        for (ml = First(nl->elem()->Get_Meths()); More(ml); ml = Next(ml)) {
+            if (!cpp_IsTraced(ml->elem())) continue;
+            os << "\t\t\"" << nl->elem()->Get_Name()->Get_Name() << "::" << ml->elem()->Get_Name() << "\"," << std::endl;
+        }
+    }
+
+    os << "\t\t\"\"" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+    os << "\treturn names[m];" << std::endl;
+    os << "}" << std::endl;
+    os << "#endif" << std::endl;
+    os << std::endl << std::endl;
+}
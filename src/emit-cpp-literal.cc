@@ -0,0 +1,117 @@
+//===================================================================================================================
+// emit-cpp-literal.cc -- This file is responsible for emitting the CPP literal trees
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// A literal tree is a tree that is known when the AST source is written (a prelude, a table of built-in
+// declarations, a default configuration) and so can be built by the compiler rather than at run time.  All of its
+// nodes are members of one struct, each built by the constexpr literal constructor of its node, and the children
+// are the addresses of the other members.  So the struct is constant-initialized: there is no code to run and no
+// allocation when the program starts, and the nodes sit next to each other in the order of a postorder walk.
+//
+// The struct is a static member of a class template, so the header can be included in any number of translation
+// units and there is still only one copy of the tree.  Since the nodes have virtual destructors, the compiler puts
+// the struct in writable data rather than read-only data, and registers one destructor call for it at exit.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitLiteralMembers() -- Emit the members of a literal tree struct, one for each node in postorder
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitLiteralMembers(std::ofstream &os, LitNode *ln)
+{
+    for (LitList *al = First(ln->Get_Args()); More(al); al = Next(al)) {
+        if (al->elem()->Get_Kind()) cpp_EmitLiteralMembers(os, al->elem());
+    }
+
+    os << "\t" << ln->Get_Kind()->Get_Name() << " n" << ln->Get_Index() << ";" << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitLiteralNodes() -- Emit the initializers of the members of a literal tree struct, in postorder
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitLiteralNodes(std::ofstream &os, LitNode *ln)
+{
+    for (LitList *al = First(ln->Get_Args()); More(al); al = Next(al)) {
+        if (al->elem()->Get_Kind()) cpp_EmitLiteralNodes(os, al->elem());
+    }
+
+    if (ln->Get_Index()) os << "," << std::endl;
+    os << "\t{ ASTLiteral()";
+
+    for (LitList *al = First(ln->Get_Args()); More(al); al = Next(al)) {
+        LitNode *arg = al->elem();
+
+        if (arg->Get_Kind()) {
+            os << ", const_cast<" << arg->Get_Kind()->Get_Name() << " *>(&tree.n" << arg->Get_Index() << ")";
+        } else os << ", " << arg->Get_Code();
+    }
+
+    os << " }";
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitLiterals() -- Emit the literal trees, each with a function that returns its root
+//
+// The nodes are initialized in postorder, so the root is the last member.  The root is returned without its
+// const, since the nodes are used through the same interfaces as any other; but they must never be changed or
+// deleted.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitLiterals(std::ofstream &os)
+{
+    if (!literals) return;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The literal trees, which are built by the compiler; do not change or delete their nodes" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+
+    for (LiteralList *ll = First(literals); More(ll); ll = Next(ll)) {
+        Literal *l = ll->elem();
+        LitNode *root = l->Get_Tree();
+        std::string type = "ASTLiteralTree_" + l->Get_Name();
+
+        os << "struct " << type << " {" << std::endl;
+        cpp_EmitLiteralMembers(os, root);
+        os << std::endl;
+        os << "\ttemplate <int I = 0> struct Holder { static const " << type << " tree; };" << std::endl;
+        os << "};" << std::endl << std::endl;
+
+        os << "template <int I> const " << type << " " << type << "::Holder<I>::tree = {" << std::endl;
+        cpp_EmitLiteralNodes(os, root);
+        os << std::endl << "};" << std::endl << std::endl;
+
+        os << "inline " << l->Get_Type()->Get_Name() << " *" << l->Get_Name() << "(void) { return const_cast<"
+                << root->Get_Kind()->Get_Name() << " *>(&" << type << "::Holder<>::tree.n" << root->Get_Index()
+                << "); }" << std::endl << std::endl << std::endl;
+    }
+}
@@ -0,0 +1,319 @@
+//===================================================================================================================
+// emit-cpp-reflect.cc -- This file is responsible for emitting the CPP reflection tables for the nodes
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Generic code (dumpers, differs, serializers) needs to know the fields of each node type.  Rather than a virtual
+// function per node type, each node type gets a specialization of ASTReflect<> that describes it with constexpr
+// members, so the code can be written once as a template, and a runtime table of the same information indexed
+// by the type.
+//
+// The nodes are numbered in preorder of the hierarchy, so the concrete nodes derived from any node have a range
+// of consecutive node type tags.  Checking whether a node is derived from a type is then a range check on its tag.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+// 2026-10-18    N/A    v0.1.1   ADCL  Flag the interned attributes
+// 2026-10-18    N/A    v0.1.1   ADCL  Locate the bits(N) attributes within their packed word
+// 2026-10-18    N/A    v0.1.1   ADCL  Flag the lazy attributes
+// 2026-10-18    N/A    v0.1.1   ADCL  Leave the Field() index unnamed for a node with no fields
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_ReflectFields() -- Get the attributes that are stored in a node, starting with those inherited
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_ReflectFields(Node *node, std::vector<Attribute *> &fields)
+{
+    if (!node) return;
+
+    cpp_ReflectFields(node->Get_Parent(), fields);
+
+    for (AttrList *al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        if (!(al->elem()->Get_Flags() & STATIC)) fields.push_back(al->elem());
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_ReflectFlags() -- Get the field flags for an attribute stored in a node
+//-------------------------------------------------------------------------------------------------------------------
+static std::string cpp_ReflectFlags(Node *node, Attribute *a)
+{
+    std::string rv;
+    int f = a->Get_Flags();
+
+    if (f & PUBLIC) rv = "AST_FIELD_PUBLIC";
+    else if (f & PRIVATE) rv = "AST_FIELD_PRIVATE";
+    else rv = "AST_FIELD_PROTECTED";
+
+    if (f & NOINIT) rv += " | AST_FIELD_NOINIT";
+    if (f & COMPUTED) rv += " | AST_FIELD_COMPUTED";
+    if (f & LAZY) rv += " | AST_FIELD_LAZY";
+    if (f & OWNED) rv += " | AST_FIELD_OWNED";
+    if (f & INTERNED) rv += " | AST_FIELD_INTERNED";
+    if (f & BITS) rv += " | AST_FIELD_BITS";
+    if (a->Is_Child()) rv += " | AST_FIELD_CHILD";
+
+    for (Node *n = node; n; n = n->Get_Parent()) {
+        for (AttrList *al = First(n->Get_Attrs()); More(al); al = Next(al)) {
+            if (al->elem() == a && (n->Get_Flags() & IMMUTABLE) && !(f & LAZY)) rv += " | AST_FIELD_CONST";
+        }
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_ReflectOwner() -- Get the node that defines an attribute stored in a node
+//-------------------------------------------------------------------------------------------------------------------
+static Node *cpp_ReflectOwner(Node *node, Attribute *a)
+{
+    for (Node *n = node; n; n = n->Get_Parent()) {
+        for (AttrList *al = First(n->Get_Attrs()); More(al); al = Next(al)) {
+            if (al->elem() == a) return n;
+        }
+    }
+
+    return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_ReflectIndex() -- Get the position of a node in the list of nodes, which is in preorder of the hierarchy
+//-------------------------------------------------------------------------------------------------------------------
+static int cpp_ReflectIndex(Node *node)
+{
+    int rv = 0;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        if (nl->elem() == node) return rv;
+        rv ++;
+    }
+
+    return -1;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_ReflectRange() -- Get the range of node type tags of the concrete nodes derived from a node
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_ReflectRange(Node *node, int &first, int &last)
+{
+    int tag = 0;
+
+    first = -1;
+    last = -1;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        if (n == node) first = tag;
+        if (first >= 0 && last < 0 && !n->Is_A(node)) last = tag;
+        if (!(n->Get_Flags() & ABSTRACT)) tag ++;
+    }
+
+    if (last < 0) last = tag;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitReflectNode() -- Emit the ASTReflect<> specialization for a node
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitReflectNode(std::ofstream &os, Node *node)
+{
+    std::string name = node->Get_Name()->Get_Name();
+    std::vector<Attribute *> fields;
+    int depth = 0;
+    int first, last;
+
+    cpp_ReflectFields(node, fields);
+    cpp_ReflectRange(node, first, last);
+    for (Node *n = node->Get_Parent(); n; n = n->Get_Parent()) depth ++;
+
+    os << "template <> struct ASTReflect<" << name << "> {" << std::endl;
+    os << "\ttypedef " << (node->Get_Parent() ? node->Get_Parent()->Get_Name()->Get_Name() : std::string("void"))
+            << " Parent;" << std::endl;
+    os << "\tstatic constexpr ASTTypeIndex index = AST_TYPE_" << name << ";" << std::endl;
+    os << "\tstatic constexpr const char *name = \"" << name << "\";" << std::endl;
+    os << "\tstatic constexpr int depth = " << depth << ";" << std::endl;
+    os << "\tstatic constexpr bool abstract = " << (node->Get_Flags() & ABSTRACT ? "true" : "false") << ";"
+            << std::endl;
+    os << "\tstatic constexpr int first = " << first << ";" << std::endl;
+    os << "\tstatic constexpr int last = " << last << ";" << std::endl;
+    os << "\tstatic constexpr int fieldCount = " << fields.size() << ";" << std::endl << std::endl;
+
+    // -- the index is left unnamed when there are no fields to compare it against (-Wunused-parameter)
+    os << "\tstatic constexpr ASTFieldInfo Field(int" << (fields.empty() ? "" : " i") << ") {" << std::endl;
+    os << "\t\treturn ";
+
+    for (size_t i = 0; i < fields.size(); i ++) {
+        Attribute *a = fields[i];
+        Node *owner = cpp_ReflectOwner(node, a);
+
+        os << "i == " << i << " ? ASTFieldInfo { \"" << a->Get_Name() << "\", \"" << a->Get_Type()->Get_Name()
+                << "\", " << (a->Get_Type()->Get_Kind() == NODE ? "true" : "false") << ", offsetof(" << name << ", ";
+
+        if (a->Get_Bits()) {
+            os << "_" << owner->Get_Name()->Get_Name() << "_bits), " << cpp_ReflectFlags(node, a) << ", "
+                    << owner->GetBitsShift(a) << ", " << a->Get_Bits();
+        } else {
+            os << a->Get_Name() << "), " << cpp_ReflectFlags(node, a) << ", 0, 0";
+        }
+
+        os << " } :" << std::endl << "\t\t\t";
+    }
+
+    os << "ASTFieldInfo { NULL, NULL, false, 0, 0, 0, 0 };" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstatic const ASTFieldInfo *Fields(void) {" << std::endl;
+
+    if (fields.empty()) {
+        os << "\t\treturn NULL;" << std::endl;
+    } else {
+        os << "\t\tstatic const ASTFieldInfo fields[] = {";
+        for (size_t i = 0; i < fields.size(); i ++) os << (i ? ", " : " ") << "Field(" << i << ")";
+        os << " };" << std::endl;
+        os << "\t\treturn fields;" << std::endl;
+    }
+
+    os << "\t}" << std::endl;
+    os << "};" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitReflection() -- Emit the reflection tables for all the nodes
+//
+// Like the child slot tables, the field offsets are taken with offsetof() on classes with virtual functions, so
+// the warning is suppressed around them.  ASTReflect<> is a friend of every node for the protected and private
+// attributes.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitReflection(std::ofstream &os)
+{
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+    NodeList *nl;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The reflection tables describe each node type and the attributes stored in it" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "typedef enum {" << std::endl;
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        os << "\tAST_TYPE_" << nl->elem()->Get_Name()->Get_Name() << "," << std::endl;
+    }
+    os << "\tAST_TYPE_COUNT" << std::endl;
+    os << "} ASTTypeIndex;" << std::endl << std::endl;
+
+    os << "typedef enum {" << std::endl;
+    os << "\tAST_FIELD_PUBLIC    = 0x0001," << std::endl;
+    os << "\tAST_FIELD_PROTECTED = 0x0002," << std::endl;
+    os << "\tAST_FIELD_PRIVATE   = 0x0004," << std::endl;
+    os << "\tAST_FIELD_NOINIT    = 0x0008," << std::endl;
+    os << "\tAST_FIELD_COMPUTED  = 0x0010," << std::endl;
+    os << "\tAST_FIELD_OWNED     = 0x0020," << std::endl;
+    os << "\tAST_FIELD_CHILD     = 0x0040," << std::endl;
+    os << "\tAST_FIELD_CONST     = 0x0080," << std::endl;
+    os << "\tAST_FIELD_INTERNED  = 0x0100," << std::endl;
+    os << "\tAST_FIELD_BITS      = 0x0200," << std::endl;
+    os << "\tAST_FIELD_LAZY      = 0x0400," << std::endl;
+    os << "} ASTFieldFlags;" << std::endl << std::endl;
+
+    os << "struct ASTFieldInfo {" << std::endl;
+    os << "\tconst char *name;" << std::endl;
+    os << "\tconst char *type;" << std::endl;
+    os << "\tbool node;" << std::endl;
+    os << "\tsize_t offset;" << std::endl;
+    os << "\tunsigned int flags;" << std::endl;
+    os << "\tint shift;" << std::endl;
+    os << "\tint width;" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "struct ASTTypeInfo {" << std::endl;
+    os << "\tconst char *name;" << std::endl;
+    os << "\tint parent;" << std::endl;
+    os << "\tint depth;" << std::endl;
+    os << "\tbool abstract;" << std::endl;
+    os << "\tint first;" << std::endl;
+    os << "\tint last;" << std::endl;
+    os << "\tint fieldCount;" << std::endl;
+    os << "\tconst ASTFieldInfo *fields;" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "#if defined(__GNUC__)" << std::endl;
+    os << "#pragma GCC diagnostic push" << std::endl;
+    os << "#pragma GCC diagnostic ignored \"-Winvalid-offsetof\"" << std::endl;
+    os << "#endif" << std::endl << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) cpp_EmitReflectNode(os, nl->elem());
+
+    os << "#if defined(__GNUC__)" << std::endl;
+    os << "#pragma GCC diagnostic pop" << std::endl;
+    os << "#endif" << std::endl << std::endl;
+
+    //
+    // -- the runtime tables, by type index and by node type tag
+    //    ------------------------------------------------------
+    os << "inline const ASTTypeInfo &ASTTypeTable(ASTTypeIndex i) {" << std::endl;
+    os << "\tstatic const ASTTypeInfo types[] = {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::string r = "ASTReflect<" + n->Get_Name()->Get_Name() + ">::";
+
+        os << "\t\t{ " << r << "name, " << cpp_ReflectIndex(n->Get_Parent()) << ", " << r << "depth, " << r
+                << "abstract, " << r << "first, " << r << "last, " << r << "fieldCount, " << r << "Fields() },"
+                << std::endl;
+    }
+
+    os << "\t};" << std::endl << std::endl;
+    os << "\treturn types[i];" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline const ASTTypeInfo &ASTTypeOf(ASTNodeType t) {" << std::endl;
+    os << "\tstatic const ASTTypeIndex index[] = {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        if (nl->elem()->Get_Flags() & ABSTRACT) continue;
+        os << "\t\tAST_TYPE_" << nl->elem()->Get_Name()->Get_Name() << "," << std::endl;
+    }
+
+    os << "\t};" << std::endl << std::endl;
+    os << "\treturn ASTTypeTable(index[t]);" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    //
+    // -- with the tags in preorder, being derived from a type is a range check
+    //    ---------------------------------------------------------------------
+    os << "template <class T> inline bool ASTIsA(const " << root << " *n) {" << std::endl;
+    os << "\treturn n && n->_GetTag() >= ASTReflect<T>::first && n->_GetTag() < ASTReflect<T>::last;" << std::endl;
+    os << "}" << std::endl;
+    os << std::endl << std::endl;
+}
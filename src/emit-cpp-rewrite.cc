@@ -0,0 +1,548 @@
+//===================================================================================================================
+// emit-cpp-rewrite.cc -- This file is responsible for emitting the CPP rewrite rule matcher and driver
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// The rewrite rules are not matched one at a time.  Instead, all of the rules are compiled together into a single
+// decision tree.  Each rule is reduced to a list of tests of the form "the node at this path has one of these
+// node types", where a path is the sequence of child slots from the root of the match.  The tree is built by
+// taking the first test of the highest priority rule that is still possible and switching on the node type at
+// that path; each case continues with only the rules that are still possible for that node type.  As a result,
+// the node type at any path is tested at most once during a match, no matter how many rules look at it.
+//
+// Since the root of every rule is a node kind, the first switch is always on the type of the node being matched.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+// 2026-10-18    N/A    v0.1.1   ADCL  Keep the parent links when a rewrite replaces the root
+// 2026-10-18    N/A    v0.1.1   ADCL  Copy the path to a rewrite through immutable nodes
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+
+//
+// -- A test the decision tree must make: the node at the path must be of the kind
+//    ----------------------------------------------------------------------------
+struct Test {
+    std::string path;
+    Node *kind;
+};
+
+
+//
+// -- A name bound by a rule: the node at the path, passed to the rule as the type
+//    ----------------------------------------------------------------------------
+struct Binding {
+    std::string name;
+    std::string path;
+    std::string type;
+};
+
+
+//
+// -- A rule as the decision tree sees it: the tests that remain and the bindings
+//    ---------------------------------------------------------------------------
+struct Candidate {
+    int id;
+    Rewrite *rule;
+    std::vector<Test> tests;
+    std::vector<Binding> bindings;
+};
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_PathVar() -- The name of the variable that holds the node at a path
+//-------------------------------------------------------------------------------------------------------------------
+static std::string cpp_PathVar(const std::string &path)
+{
+    return (path == "" ? std::string("n") : "n_" + path);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_CollectPattern() -- Flatten a pattern into tests and bindings; the tests are collected in preorder so that
+//                         the test of a node always comes before the tests of its children
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_CollectPattern(Candidate &c, Pattern *p, const std::string &path, const std::string &type)
+{
+    Node *kind = (p->Get_Kind()?GetNode(p->Get_Kind()):NULL);
+
+    if (p->Get_Binding() != "") {
+        Binding b = { p->Get_Binding(), path, (kind?kind->Get_Name()->Get_Name():type) };
+        c.bindings.push_back(b);
+    }
+
+    if (!kind) return;
+
+    Test t = { path, kind };
+    c.tests.push_back(t);
+
+    int i = 0;
+
+    for (PatList *pl = First(p->Get_Args()); More(pl); pl = Next(pl), i ++) {
+        std::ostringstream child;
+
+        child << path << (path == "" ? "" : "_") << i;
+        cpp_CollectPattern(c, pl->elem(), child.str(), kind->GetChildAttr(i)->Get_Type()->Get_Name());
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitPathVar() -- Emit the declaration of the node at a path, whose parent is already declared
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitPathVar(std::ofstream &os, const std::string &indent, const std::string &path,
+        std::vector<std::string> &declared)
+{
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+
+    for (size_t i = 0; i < declared.size(); i ++) {
+        if (declared[i] == path) return;
+    }
+
+    size_t sep = path.rfind('_');
+    std::string parent = (sep == std::string::npos ? std::string("") : path.substr(0, sep));
+    std::string slot = (sep == std::string::npos ? path : path.substr(sep + 1));
+
+    os << indent << root << " *" << cpp_PathVar(path) << " = ASTNodeMeta::GetSlot(" << cpp_PathVar(parent)
+            << ", ASTNodeMeta::ChildTable(" << cpp_PathVar(parent) << "->_GetTag()).slots[" << slot << "]);" << std::endl;
+    declared.push_back(path);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitRuleCall() -- Emit the call to a rule whose tests have all passed
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitRuleCall(std::ofstream &os, const std::string &indent, Candidate *c,
+        std::vector<std::string> declared)
+{
+    os << indent << "{" << std::endl;
+
+    for (size_t i = 0; i < c->bindings.size(); i ++) cpp_EmitPathVar(os, indent + "\t", c->bindings[i].path, declared);
+
+    os << indent << "\tif ((rv = Rule_" << c->id << "(";
+
+    for (size_t i = 0; i < c->bindings.size(); i ++) {
+        if (i) os << ", ";
+        os << "static_cast<" << c->bindings[i].type << " *>(" << cpp_PathVar(c->bindings[i].path) << ")";
+    }
+
+    os << ")) != NULL) return rv;" << std::endl;
+    os << indent << "}" << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitDecision() -- Emit the decision tree for the rules that are still possible, in priority order
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitDecision(std::ofstream &os, const std::string &indent, std::vector<Candidate *> cands,
+        std::vector<std::string> declared)
+{
+    //
+    // -- rules that have nothing left to test are tried in order until one has a test left
+    //    ---------------------------------------------------------------------------------
+    while (!cands.empty() && cands[0]->tests.empty()) {
+        cpp_EmitRuleCall(os, indent, cands[0], declared);
+        cands.erase(cands.begin());
+    }
+
+    if (cands.empty()) return;
+
+    //
+    // -- switch on the node type at the first path the highest priority rule tests
+    //    -------------------------------------------------------------------------
+    std::string path = cands[0]->tests[0].path;
+    std::string var = cpp_PathVar(path);
+
+    cpp_EmitPathVar(os, indent, path, declared);
+
+    if (path == "") os << indent << "switch ((int)" << var << "->_GetTag()) {" << std::endl;
+    else os << indent << "switch (" << var << " ? (int)" << var << "->_GetTag() : -1) {" << std::endl;
+
+    //
+    // -- For each concrete node type, work out the rules that remain possible.  Node types that leave the
+    //    same rules possible share a case, and the rules that do not test this path at all are the default.
+    //    ---------------------------------------------------------------------------------------------------
+    std::vector<std::string> keys;
+    std::vector<std::string> labels;
+    std::string dflt(cands.size(), '0');
+
+    for (size_t i = 0; i < cands.size(); i ++) {
+        bool tested = false;
+
+        for (size_t j = 0; j < cands[i]->tests.size(); j ++) if (cands[i]->tests[j].path == path) tested = true;
+        if (!tested) dflt[i] = '1';
+    }
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::string key = dflt;
+        bool used = false;
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+
+        for (size_t i = 0; i < cands.size(); i ++) {
+            for (size_t j = 0; j < cands[i]->tests.size(); j ++) {
+                if (cands[i]->tests[j].path == path && n->Is_A(cands[i]->tests[j].kind)) {
+                    key[i] = '1';
+                    used = true;
+                }
+            }
+        }
+
+        if (!used) continue;
+
+        size_t k;
+
+        for (k = 0; k < keys.size(); k ++) if (keys[k] == key) break;
+
+        if (k == keys.size()) {
+            keys.push_back(key);
+            labels.push_back("");
+        }
+
+        labels[k] += indent + "case NODE_TYPE_" + n->Get_Name()->Get_Name() + ":\n";
+    }
+
+    for (size_t k = 0; k < keys.size(); k ++) {
+        std::vector<Candidate *> next;
+        std::vector<Candidate> trimmed(cands.size());
+
+        for (size_t i = 0; i < cands.size(); i ++) {
+            if (keys[k][i] == '0') continue;
+
+            trimmed[i] = *cands[i];
+            trimmed[i].tests.clear();
+
+            for (size_t j = 0; j < cands[i]->tests.size(); j ++) {
+                if (cands[i]->tests[j].path != path) trimmed[i].tests.push_back(cands[i]->tests[j]);
+            }
+
+            next.push_back(&trimmed[i]);
+        }
+
+        os << labels[k].substr(0, labels[k].size() - 1) << " {" << std::endl;
+        cpp_EmitDecision(os, indent + "\t", next, declared);
+        os << indent << "\tbreak;" << std::endl;
+        os << indent << "}" << std::endl;
+    }
+
+    std::vector<Candidate *> rest;
+
+    for (size_t i = 0; i < cands.size(); i ++) if (dflt[i] == '1') rest.push_back(cands[i]);
+
+    if (!rest.empty()) {
+        os << indent << "default: {" << std::endl;
+        cpp_EmitDecision(os, indent + "\t", rest, declared);
+        os << indent << "\tbreak;" << std::endl;
+        os << indent << "}" << std::endl;
+    }
+
+    os << indent << "}" << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitDiscard() -- Emit Discard(), which deletes the node displaced from an owned slot by a rewrite
+//
+// The replacement may well be built from the children of the displaced node, so those are taken out of their
+// slots before it is deleted.  When the replacement is one of the rewritten nodes below the displaced node, only
+// that node needs to be kept; otherwise every node of the replacement is.  A replacement that holds the displaced
+// node itself keeps all of it.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitDiscard(std::ofstream &os, const std::string &root)
+{
+    os << "\t//" << std::endl;
+    os << "\t// -- Delete the node displaced from an owned slot, keeping what the replacement uses" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic void Discard(" << root << " *old, " << root << " *r, bool rewritten) {" << std::endl;
+    os << "\t\tstd::unordered_set<" << root << " *> keep;" << std::endl;
+    os << "\t\tstd::vector<" << root << " *> work(1, r);" << std::endl << std::endl;
+    os << "\t\twhile (!work.empty()) {" << std::endl;
+    os << "\t\t\t" << root << " *n = work.back();" << std::endl << std::endl;
+    os << "\t\t\twork.pop_back();" << std::endl;
+    os << "\t\t\tif (!n || !keep.insert(n).second || rewritten) continue;" << std::endl;
+    os << "\t\t\tfor (int i = 0; i < n->_ChildCount(); i ++) work.push_back(n->_Child(i));" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tif (keep.count(old)) return;" << std::endl << std::endl;
+    os << "\t\twork.push_back(old);" << std::endl;
+    os << "\t\twhile (!work.empty()) {" << std::endl;
+    os << "\t\t\t" << root << " *n = work.back();" << std::endl;
+    os << "\t\t\tconst ASTChildTable &t = ASTNodeMeta::ChildTable(n->_GetTag());" << std::endl << std::endl;
+    os << "\t\t\twork.pop_back();" << std::endl;
+    os << "\t\t\tfor (int i = 0; i < t.count; i ++) {" << std::endl;
+    os << "\t\t\t\t" << root << " *c = ASTNodeMeta::GetSlot(n, t.slots[i]);" << std::endl << std::endl;
+    os << "\t\t\t\tif (!c || !t.slots[i].owned) continue;" << std::endl;
+    os << "\t\t\t\tif (keep.count(c)) ASTNodeMeta::TakeSlot(n, t.slots[i]);" << std::endl;
+    os << "\t\t\t\telse work.push_back(c);" << std::endl;
+    os << "\t\t\t}" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tdelete old;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitRewriteInPlace() -- Emit the body of the fixpoint driver, which replaces the rewritten children in place
+//
+// A node is matched only once its whole subtree is rewritten, so when the replacement is a node from below it (a
+// rule that returns a node it was given), only the replacement itself is matched again; any other replacement is
+// walked in full.  Below() looks for it no deeper than the rules bind their nodes.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitRewriteInPlace(std::ofstream &os, const std::string &root)
+{
+    os << "\t\tstruct Frame {" << std::endl;
+    os << "\t\t\t" << root << " *node;" << std::endl;
+    os << "\t\t\tconst ASTChildTable *table;" << std::endl;
+    os << "\t\t\tint next;" << std::endl;
+    os << "\t\t};" << std::endl << std::endl;
+    os << "\t\tstd::vector<Frame> stack;" << std::endl;
+    os << "\t\t" << root << " *rv = tree;" << std::endl;
+    os << "\t\tlong count = 0;" << std::endl << std::endl;
+    os << "\t\tif (tree) {" << std::endl;
+    os << "\t\t\tFrame f = { tree, &ASTNodeMeta::ChildTable(tree->_GetTag()), 0 };" << std::endl;
+    os << "\t\t\tstack.push_back(f);" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\twhile (!stack.empty()) {" << std::endl;
+    os << "\t\t\tFrame &t = stack.back();" << std::endl << std::endl;
+    os << "\t\t\tif (t.next < t.table->count) {" << std::endl;
+    os << "\t\t\t\t" << root << " *c = ASTNodeMeta::GetSlot(t.node, t.table->slots[t.next ++]);" << std::endl << std::endl;
+    os << "\t\t\t\tif (c) {" << std::endl;
+    os << "\t\t\t\t\tFrame f = { c, &ASTNodeMeta::ChildTable(c->_GetTag()), 0 };" << std::endl;
+    os << "\t\t\t\t\tstack.push_back(f);" << std::endl;
+    os << "\t\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\t\tcontinue;" << std::endl;
+    os << "\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\t" << root << " *r = Match(t.node);" << std::endl << std::endl;
+    os << "\t\t\tif (r && r != t.node) {" << std::endl;
+    os << "\t\t\t\tbool rewritten = Below(t.node, r, BOUND_DEPTH);" << std::endl << std::endl;
+    os << "\t\t\t\tcount ++;" << std::endl << std::endl;
+    os << "\t\t\t\tif (stack.size() > 1) {" << std::endl;
+    os << "\t\t\t\t\tFrame &p = stack[stack.size() - 2];" << std::endl;
+    os << "\t\t\t\t\tconst ASTChildSlot &s = p.table->slots[p.next - 1];" << std::endl << std::endl;
+    os << "\t\t\t\t\tASTNodeMeta::SetSlot(p.node, s, r);" << std::endl;
+    if (HasOwnedAttrs()) os << "\t\t\t\t\tif (s.owned) Discard(t.node, r, rewritten);" << std::endl;
+    if (NeedParentLinks()) {
+        os << "\t\t\t\t} else {" << std::endl;
+        os << "\t\t\t\t\tASTNodeMeta::SetParent(r, tree->_GetParent());" << std::endl;
+        os << "\t\t\t\t\trv = r;" << std::endl;
+        os << "\t\t\t\t}" << std::endl << std::endl;
+    } else {
+        os << "\t\t\t\t} else rv = r;" << std::endl << std::endl;
+    }
+    os << "\t\t\t\tt.node = r;" << std::endl;
+    os << "\t\t\t\tt.table = &ASTNodeMeta::ChildTable(r->_GetTag());" << std::endl;
+    os << "\t\t\t\tt.next = (rewritten ? t.table->count : 0);" << std::endl;
+    os << "\t\t\t\tcontinue;" << std::endl;
+    os << "\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\tstack.pop_back();" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitRewriteCopying() -- Emit the body of the fixpoint driver when there are immutable nodes
+//
+// An immutable node cannot have its child replaced, so each frame remembers the node it started with.  When a
+// frame is finished with a different node than it started with, the change is passed to its parent with
+// _WithChild(), which copies an immutable parent (changing its frame in turn) and updates any other in place.
+// The result is that only the path from a rewrite up to the first mutable node is copied.  As in
+// cpp_EmitRewriteInPlace(), a node a rule returns from below is not walked again.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitRewriteCopying(std::ofstream &os, const std::string &root)
+{
+    os << "\t\tstruct Frame {" << std::endl;
+    os << "\t\t\t" << root << " *node;" << std::endl;
+    os << "\t\t\t" << root << " *orig;" << std::endl;
+    os << "\t\t\tconst ASTChildTable *table;" << std::endl;
+    os << "\t\t\tint next;" << std::endl;
+    os << "\t\t};" << std::endl << std::endl;
+    os << "\t\tstd::vector<Frame> stack;" << std::endl;
+    os << "\t\t" << root << " *rv = tree;" << std::endl;
+    os << "\t\tlong count = 0;" << std::endl << std::endl;
+    os << "\t\tif (tree) {" << std::endl;
+    os << "\t\t\tFrame f = { tree, tree, &ASTNodeMeta::ChildTable(tree->_GetTag()), 0 };" << std::endl;
+    os << "\t\t\tstack.push_back(f);" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\twhile (!stack.empty()) {" << std::endl;
+    os << "\t\t\tFrame &t = stack.back();" << std::endl << std::endl;
+    os << "\t\t\tif (t.next < t.table->count) {" << std::endl;
+    os << "\t\t\t\t" << root << " *c = ASTNodeMeta::GetSlot(t.node, t.table->slots[t.next ++]);" << std::endl << std::endl;
+    os << "\t\t\t\tif (c) {" << std::endl;
+    os << "\t\t\t\t\tFrame f = { c, c, &ASTNodeMeta::ChildTable(c->_GetTag()), 0 };" << std::endl;
+    os << "\t\t\t\t\tstack.push_back(f);" << std::endl;
+    os << "\t\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\t\tcontinue;" << std::endl;
+    os << "\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\t" << root << " *r = Match(t.node);" << std::endl << std::endl;
+    os << "\t\t\tif (r && r != t.node) {" << std::endl;
+    os << "\t\t\t\tbool rewritten = Below(t.node, r, BOUND_DEPTH);" << std::endl << std::endl;
+    os << "\t\t\t\tcount ++;" << std::endl;
+    os << "\t\t\t\tt.node = r;" << std::endl;
+    os << "\t\t\t\tt.table = &ASTNodeMeta::ChildTable(r->_GetTag());" << std::endl;
+    os << "\t\t\t\tt.next = (rewritten ? t.table->count : 0);" << std::endl;
+    os << "\t\t\t\tcontinue;" << std::endl;
+    os << "\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\tFrame done = t;" << std::endl << std::endl;
+    os << "\t\t\tstack.pop_back();" << std::endl;
+    os << "\t\t\tif (done.node == done.orig) continue;" << std::endl << std::endl;
+    os << "\t\t\tif (!stack.empty()) {" << std::endl;
+    os << "\t\t\t\tFrame &p = stack.back();" << std::endl;
+    os << "\t\t\t\tp.node = p.node->_WithChild(p.next - 1, done.node);" << std::endl;
+    os << "\t\t\t} else rv = done.node;" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitRewriter() -- Emit the rewrite rules, the decision tree matcher and the fixpoint driver
+//
+// The ASTRewriter has 3 parts:
+// A) A static function for each rule, which checks the guard and runs the code; the code returns the replacement
+//    or NULL to decline the match
+// B) Match(), the decision tree, which returns the replacement from the first rule that matches and does not
+//    decline, or NULL
+// C) Rewrite(), which applies Match() bottom-up (children before their parent) until nothing changes.  When a
+//    node is replaced, the replacement takes its place and is itself rewritten, children first (but a node the
+//    rule was given is already rewritten below, so only it is matched again).  A node replaced in an owned slot
+//    is deleted, keeping the parts the replacement reuses; the other replaced nodes are not deleted, since the
+//    rules may well have reused them.  With immutable nodes no replaced node is deleted, since they are shared.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitRewriter(std::ofstream &os)
+{
+    if (!rewrites) return;
+
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+    std::vector<Candidate> cands;
+    RewriteList *rl;
+    int id = 1;
+    int depth = 0;
+
+    for (rl = First(rewrites); More(rl); rl = Next(rl), id ++) {
+        Candidate c;
+
+        c.id = id;
+        c.rule = rl->elem();
+        cpp_CollectPattern(c, c.rule->Get_Pattern(), "", root);
+        cands.push_back(c);
+
+        for (size_t j = 0; j < c.bindings.size(); j ++) {
+            const std::string &path = c.bindings[j].path;
+            int d = (path == "" ? 0 : 1 + (int)std::count(path.begin(), path.end(), '_'));
+
+            if (d > depth) depth = d;
+        }
+    }
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTRewriter -- the rewrite rules compiled into a single decision tree, and the driver" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "struct ASTRewriter {" << std::endl;
+
+    //
+    // -- the rules
+    //    ---------
+    for (size_t i = 0; i < cands.size(); i ++) {
+        Candidate &c = cands[i];
+
+        os << "\t//" << std::endl;
+        os << "\t// -- The rewrite rule from line " << c.rule->Get_Line() << std::endl;
+        os << "\t//---------------------------------------------------------------------------------" << std::endl;
+        os << "\tstatic " << root << " *Rule_" << c.id << "(";
+
+        if (c.bindings.empty()) os << "void";
+
+        for (size_t j = 0; j < c.bindings.size(); j ++) {
+            if (j) os << ", ";
+            os << c.bindings[j].type << " *" << c.bindings[j].name;
+        }
+
+        os << ") {" << std::endl;
+
+        for (size_t j = 0; j < c.bindings.size(); j ++) os << "\t\t(void)" << c.bindings[j].name << ";" << std::endl;
+        if (c.rule->Get_Guard() != "") os << "\t\tif (!(" << c.rule->Get_Guard() << ")) return NULL;" << std::endl;
+
+        os << "\t\t" << c.rule->Get_Code() << std::endl;
+        os << "\t\treturn NULL;" << std::endl;
+        os << "\t}" << std::endl << std::endl;
+    }
+
+    //
+    // -- the matcher
+    //    -----------
+    std::vector<Candidate *> all;
+    std::vector<std::string> declared;
+
+    for (size_t i = 0; i < cands.size(); i ++) all.push_back(&cands[i]);
+    declared.push_back("");
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Match a node against all the rules; returns the replacement or NULL" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic " << root << " *Match(" << root << " *n) {" << std::endl;
+    os << "\t\t" << root << " *rv;" << std::endl << std::endl;
+    os << "\t\tif (!n) return NULL;" << std::endl << std::endl;
+
+    cpp_EmitDecision(os, "\t\t", all, declared);
+
+    os << std::endl << "\t\treturn NULL;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Determine if r is in the subtree below n, no more than depth levels down" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tenum { BOUND_DEPTH = " << depth << " };" << std::endl << std::endl;
+    os << "\tstatic bool Below(const " << root << " *n, const " << root << " *r, int depth) {" << std::endl;
+    os << "\t\tconst ASTChildTable &t = ASTNodeMeta::ChildTable(n->_GetTag());" << std::endl << std::endl;
+    os << "\t\tfor (int i = 0; depth > 0 && i < t.count; i ++) {" << std::endl;
+    os << "\t\t\tconst " << root << " *c = ASTNodeMeta::GetSlot(n, t.slots[i]);" << std::endl << std::endl;
+    os << "\t\t\tif (c && (c == r || Below(c, r, depth - 1))) return true;" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\treturn false;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    if (HasOwnedAttrs() && !HasImmutableNodes()) cpp_EmitDiscard(os, root);
+
+    //
+    // -- the fixpoint driver
+    //    -------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Rewrite a tree bottom-up until no rule matches; returns the new root" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic " << root << " *Rewrite(" << root << " *tree, long *changes = NULL) {" << std::endl;
+    if (HasImmutableNodes()) cpp_EmitRewriteCopying(os, root);
+    else cpp_EmitRewriteInPlace(os, root);
+
+    os << "\t\tif (changes) *changes = count;" << std::endl;
+    os << "\t\treturn rv;" << std::endl;
+    os << "\t}" << std::endl;
+
+    os << "};" << std::endl << std::endl << std::endl;
+}
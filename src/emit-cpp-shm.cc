@@ -0,0 +1,293 @@
+//===================================================================================================================
+// emit-cpp-shm.cc -- This file is responsible for emitting the CPP shared memory segments for the variant nodes
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// With the --shm option (which needs --variant), a tree can be built in a named POSIX shared memory segment by
+// one process and then read in place by others, with no copy and no serializing.  Two things keep a node from
+// being read in another process.  A vtable pointer is only good in the process that set it, which is why this
+// works only with the --variant nodes, which have none.  And a pointer is only good where the segment is mapped
+// at the same address, so a node-typed attribute is an ASTRel<T>: the distance from the attribute to the node it
+// names, which is the same wherever the segment is mapped.
+//
+// The segment starts with a header that holds the bump allocator's fill mark and the offset of the root node, and
+// two constants that make sure the reader was built from the same source and the same class layouts: a hash of the
+// nodes and attributes computed here, and a hash of the sizes of the node classes computed by the C++ compiler.
+// The reader maps the segment read-only, so a node it is given can be walked and its methods called, but any write
+// to it faults.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_ShmLayout() -- Get the constant that stands for the layout of the nodes: an FNV-1a hash of each node name,
+//                    its parent and the type and name of each of its attributes, in order
+//-------------------------------------------------------------------------------------------------------------------
+static std::string cpp_ShmLayout(void)
+{
+    std::string sig;
+    unsigned long long h = 0xcbf29ce484222325ull;
+    char buf[32];
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        sig += n->Get_Name()->Get_Name() + ":" + (n->Get_Parent() ? n->Get_Parent()->Get_Name()->Get_Name() : "")
+                + (n->Get_Flags() & ABSTRACT ? "!" : "");
+
+        for (AttrList *al = First(n->Get_Attrs()); More(al); al = Next(al)) {
+            Attribute *a = al->elem();
+
+            if (a->Get_Flags() & STATIC) continue;
+            sig += ";" + a->Get_Type()->Get_Name() + (a->Get_Type()->Get_Kind() == NODE ? " *" : " ") + a->Get_Name();
+        }
+
+        sig += "\n";
+    }
+
+    for (size_t i = 0; i < sig.size(); i ++) {
+        h ^= (unsigned char)sig[i];
+        h *= 0x100000001b3ull;
+    }
+
+    snprintf(buf, sizeof(buf), "0x%016llxull", h);
+    return std::string(buf);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitShmTypes() -- Emit the self-relative pointer and the segment (--shm only), which the nodes use
+//
+// The segment's Sizes() needs the node classes to be complete, so it is declared here and defined in cpp_EmitShm().
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitShmTypes(std::ofstream &os)
+{
+    if (!(options & OPT_SHM)) return;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTRel<T> -- A node-typed attribute, held as the distance from the attribute to the node so that" << std::endl;
+    os << "//              it is the same in every process that maps the segment; 0 is NULL" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class T> class ASTRel {" << std::endl;
+    os << "\tstd::intptr_t _off;" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tASTRel(T *p = NULL) { Set(p); }" << std::endl;
+    os << "\tASTRel(const ASTRel &o) { Set(o.Get()); }" << std::endl;
+    os << "\tASTRel &operator=(const ASTRel &o) { Set(o.Get()); return *this; }" << std::endl;
+    os << "\tASTRel &operator=(T *p) { Set(p); return *this; }" << std::endl << std::endl;
+
+    os << "\tT *Get(void) const {" << std::endl;
+    os << "\t\treturn _off ? reinterpret_cast<T *>(reinterpret_cast<std::intptr_t>(this) + _off) : NULL;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tvoid Set(T *p) { _off = p ? reinterpret_cast<std::intptr_t>(p) - reinterpret_cast<std::intptr_t>(this) "
+            ": 0; }" << std::endl;
+    os << "\toperator T *(void) const { return Get(); }" << std::endl;
+    os << "\tT *operator->(void) const { return Get(); }" << std::endl;
+    os << "};" << std::endl << std::endl << std::endl;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTShmSegment -- A named POSIX shared memory segment that the nodes are built in by one process" << std::endl;
+    os << "//                  and read in place by the others" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "class ASTShmSegment {" << std::endl;
+    os << "public:" << std::endl;
+    os << "\tstruct Header {" << std::endl;
+    os << "\t\tuint64_t magic;" << std::endl;
+    os << "\t\tuint64_t layout;" << std::endl;
+    os << "\t\tuint64_t sizes;" << std::endl;
+    os << "\t\tuint64_t size;" << std::endl;
+    os << "\t\tuint64_t used;" << std::endl;
+    os << "\t\tuint64_t root;" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    os << "\tstatic const uint64_t MAGIC = 0x31304d4853545341ull;" << std::endl;
+    os << "\tstatic const uint64_t LAYOUT = " << cpp_ShmLayout() << ";" << std::endl << std::endl;
+
+    os << "private:" << std::endl;
+    os << "\tchar *base;" << std::endl;
+    os << "\tsize_t size;" << std::endl;
+    os << "\tbool writable;" << std::endl << std::endl;
+
+    os << "\tASTShmSegment(char *b, size_t s, bool w) : base(b), size(s), writable(w) { }" << std::endl;
+    os << "\tHeader *Head(void) const { return reinterpret_cast<Header *>(base); }" << std::endl;
+    os << "\tstatic inline uint64_t Sizes(void);" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tASTShmSegment(const ASTShmSegment &) = delete;" << std::endl;
+    os << "\tASTShmSegment &operator=(const ASTShmSegment &) = delete;" << std::endl;
+    os << "\t~ASTShmSegment(void) { munmap(base, size); }" << std::endl << std::endl;
+
+    //
+    // -- creating a segment fails if the name is taken, so a stale segment is never built on by mistake
+    //    ----------------------------------------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Create a new segment of size bytes to build a tree in; NULL if it cannot (see errno)" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic ASTShmSegment *Create(const char *name, size_t size) {" << std::endl;
+    os << "\t\tif (size < sizeof(Header)) return NULL;" << std::endl << std::endl;
+    os << "\t\tint fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);" << std::endl;
+    os << "\t\tif (fd < 0) return NULL;" << std::endl << std::endl;
+    os << "\t\tif (ftruncate(fd, (off_t)size) != 0) { close(fd); shm_unlink(name); return NULL; }" << std::endl;
+    os << "\t\tvoid *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);" << std::endl;
+    os << "\t\tclose(fd);" << std::endl;
+    os << "\t\tif (p == MAP_FAILED) { shm_unlink(name); return NULL; }" << std::endl << std::endl;
+    os << "\t\tASTShmSegment *rv = new ASTShmSegment(static_cast<char *>(p), size, true);" << std::endl;
+    os << "\t\tHeader *h = rv->Head();" << std::endl;
+    os << "\t\th->magic = MAGIC;" << std::endl;
+    os << "\t\th->layout = LAYOUT;" << std::endl;
+    os << "\t\th->sizes = Sizes();" << std::endl;
+    os << "\t\th->size = size;" << std::endl;
+    os << "\t\th->used = sizeof(Header);" << std::endl;
+    os << "\t\th->root = 0;" << std::endl;
+    os << "\t\treturn rv;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- Map an existing segment read-only; NULL if it cannot, or if it was built from other nodes" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic ASTShmSegment *Open(const char *name) {" << std::endl;
+    os << "\t\tint fd = shm_open(name, O_RDONLY, 0);" << std::endl;
+    os << "\t\tstruct stat st;" << std::endl;
+    os << "\t\tif (fd < 0) return NULL;" << std::endl << std::endl;
+    os << "\t\tif (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header)) { close(fd); return NULL; }" << std::endl;
+    os << "\t\tvoid *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);" << std::endl;
+    os << "\t\tclose(fd);" << std::endl;
+    os << "\t\tif (p == MAP_FAILED) return NULL;" << std::endl << std::endl;
+    os << "\t\tASTShmSegment *rv = new ASTShmSegment(static_cast<char *>(p), (size_t)st.st_size, false);" << std::endl;
+    os << "\t\tHeader *h = rv->Head();" << std::endl;
+    os << "\t\tif (h->magic != MAGIC || h->layout != LAYOUT || h->sizes != Sizes() || h->size != rv->size) {"
+            << std::endl;
+    os << "\t\t\tdelete rv;" << std::endl;
+    os << "\t\t\treturn NULL;" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t\treturn rv;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstatic bool Unlink(const char *name) { return shm_unlink(name) == 0; }" << std::endl << std::endl;
+
+    //
+    // -- the nodes are bump allocated; they are never freed one at a time
+    //    ----------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Take n bytes from the segment; throws std::bad_alloc when it is full or read-only" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tvoid *Alloc(size_t n, size_t align) {" << std::endl;
+    os << "\t\tHeader *h = Head();" << std::endl;
+    os << "\t\tuint64_t at = (h->used + align - 1) & ~(uint64_t)(align - 1);" << std::endl << std::endl;
+    os << "\t\tif (!writable || at + n > h->size) throw std::bad_alloc();" << std::endl;
+    os << "\t\th->used = at + n;" << std::endl;
+    os << "\t\treturn base + at;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tsize_t Used(void) const { return (size_t)Head()->used; }" << std::endl;
+    os << "\tsize_t Size(void) const { return size; }" << std::endl;
+    os << "\tbool Contains(const void *p) const { return static_cast<const char *>(p) >= base && "
+            "static_cast<const char *>(p) < base + size; }" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The root of the tree, which the readers get back with the same type it was set with" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\ttemplate <class T> void SetRoot(T *n) { Head()->root = n ? (uint64_t)(reinterpret_cast<char *>(n) - base) "
+            ": 0; }" << std::endl;
+    os << "\ttemplate <class T> T *Root(void) const { uint64_t r = Head()->root; return r ? "
+            "reinterpret_cast<T *>(base + r) : NULL; }" << std::endl << std::endl;
+
+    //
+    // -- the segment in use on this thread, which is set for the life of a Scope
+    //    -----------------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The segment the Factory() functions allocate from on this thread; NULL for the heap" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic ASTShmSegment *&Current(void) { static thread_local ASTShmSegment *c = NULL; return c; }"
+            << std::endl << std::endl;
+
+    os << "\tstruct Scope {" << std::endl;
+    os << "\t\tASTShmSegment *prev;" << std::endl;
+    os << "\t\texplicit Scope(ASTShmSegment &s) : prev(Current()) { Current() = &s; }" << std::endl;
+    os << "\t\t~Scope(void) { Current() = prev; }" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    os << "\tstatic void *Allocate(size_t n, size_t align) { ASTShmSegment *c = Current(); "
+            "return c ? c->Alloc(n, align) : ::operator new(n); }" << std::endl;
+    os << "};" << std::endl << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitShm() -- Emit the hash of the node sizes and the checks on the attribute types (--shm only)
+//
+// An attribute is copied into the segment as it is, so its type must be trivially copyable; that does not catch a
+// pointer, which the program must not keep in a node that is shared.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitShm(std::ofstream &os)
+{
+    if (!(options & OPT_SHM)) return;
+
+    std::vector<std::string> types;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The sizes of the node classes, which must match between the processes sharing a segment" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "inline uint64_t ASTShmSegment::Sizes(void)" << std::endl;
+    os << "{" << std::endl;
+    os << "\tuint64_t h = 0xcbf29ce484222325ull;" << std::endl << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        std::string name = nl->elem()->Get_Name()->Get_Name();
+
+        os << "\th = (h ^ sizeof(" << name << ")) * 0x100000001b3ull;" << std::endl;
+        os << "\th = (h ^ alignof(" << name << ")) * 0x100000001b3ull;" << std::endl;
+    }
+
+    os << std::endl << "\treturn h;" << std::endl;
+    os << "}" << std::endl << std::endl << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        for (AttrList *al = First(nl->elem()->Get_Attrs()); More(al); al = Next(al)) {
+            Attribute *a = al->elem();
+            bool found = false;
+
+            if ((a->Get_Flags() & STATIC) || a->Get_Type()->Get_Kind() == NODE) continue;
+
+            for (size_t i = 0; i < types.size(); i ++) if (types[i] == a->Get_Type()->Get_Name()) found = true;
+            if (found) continue;
+
+            types.push_back(a->Get_Type()->Get_Name());
+            os << "static_assert(std::is_trivially_copyable<" << a->Get_Type()->Get_Name() << ">::value, \""
+                    << a->Get_Type()->Get_Name() << " attributes cannot be kept in a shared memory segment\");"
+                    << std::endl;
+        }
+    }
+
+    os << std::endl << std::endl;
+}
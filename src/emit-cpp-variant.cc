@@ -0,0 +1,628 @@
+//===================================================================================================================
+// emit-cpp-variant.cc -- This file is responsible for emitting the CPP nodes as plain structs and tagged unions
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// With the --variant option, the node hierarchy is treated as closed and no node has a vtable.  Each concrete
+// node is emitted as a plain class holding all of its attributes, including those it inherits, and a copy of
+// each method with code that it inherits and does not override.  Each abstract node is emitted as a tagged
+// union over its concrete descendants: the tag is the node type and the methods and attribute accessors
+// switch on it to reach the concrete node.  So a concrete node is a value that can live inline in its parent
+// or in an array, and a node-typed attribute is a pointer to the (concrete or union) node it names.
+//
+// A method without code on an abstract node is only declared on that union and is not inherited.  Static
+// attributes and methods stay with the node that declares them.
+//
+// With --shm, a node-typed attribute is held as an ASTRel<T> instead of a pointer, and each node gets a Factory()
+// that builds it in the shared memory segment in use on the thread (see emit-cpp-shm.cc).  A concrete node's
+// Factory() takes its attributes; a union's takes any of its concrete nodes.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+// 2026-10-18    N/A    v0.1.1   ADCL  Hold the node-typed attributes as ASTRel<T> and add Factory() with --shm
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_VariantType() -- Get the type name as it is declared, with the pointer for a node type
+//-------------------------------------------------------------------------------------------------------------------
+static std::string cpp_VariantType(Symbol *type)
+{
+    return type->Get_Name() + (type->Get_Kind() == NODE ? " *" : " ");
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_VariantField() -- Get the type an attribute is held as; with --shm, a node is held by its distance
+//-------------------------------------------------------------------------------------------------------------------
+static std::string cpp_VariantField(Symbol *type)
+{
+    if ((options & OPT_SHM) && type->Get_Kind() == NODE) return "ASTRel<" + type->Get_Name() + "> ";
+    return cpp_VariantType(type);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_VariantSig() -- Get the signature of a method; a more derived method with the same signature overrides it
+//-------------------------------------------------------------------------------------------------------------------
+static std::string cpp_VariantSig(Method *m)
+{
+    std::string rv = m->Get_Name() + "(";
+
+    for (ParmList *pl = First(m->Get_Parms()); More(pl); pl = Next(pl)) {
+        rv += cpp_VariantType(pl->elem()->Get_Type()) + ",";
+    }
+
+    return rv + ")";
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_VariantConcretes() -- Get the concrete nodes that an abstract node is a union over
+//-------------------------------------------------------------------------------------------------------------------
+static std::vector<Node *> cpp_VariantConcretes(Node *node)
+{
+    std::vector<Node *> rv;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        if (!(n->Get_Flags() & ABSTRACT) && n->Is_A(node)) rv.push_back(n);
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_VariantAttrs() -- Get the attributes held by the instances of a node, starting with those inherited
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_VariantAttrs(Node *node, std::vector<Attribute *> &attrs)
+{
+    if (!node) return;
+
+    cpp_VariantAttrs(node->Get_Parent(), attrs);
+
+    for (AttrList *al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        if (!(al->elem()->Get_Flags() & STATIC)) attrs.push_back(al->elem());
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_VariantMeths() -- Get the methods a concrete node implements or an abstract node dispatches, the most derived
+//                       first.  For a concrete node, these are the methods with code; an abstract node also
+//                       dispatches the abstract ones.
+//-------------------------------------------------------------------------------------------------------------------
+static std::vector<Method *> cpp_VariantMeths(Node *node)
+{
+    std::vector<Method *> rv;
+    std::vector<std::string> sigs;
+
+    for (Node *n = node; n; n = n->Get_Parent()) {
+        for (MethList *ml = First(n->Get_Meths()); More(ml); ml = Next(ml)) {
+            Method *m = ml->elem();
+            std::string sig = cpp_VariantSig(m);
+            bool found = false;
+
+            if (m->Get_Flags() & STATIC) continue;
+            if ((m->Get_Flags() & EXTERNAL) && !(m->Get_Flags() & ABSTRACT) && n != node) continue;
+            if ((m->Get_Flags() & ABSTRACT) && !(node->Get_Flags() & ABSTRACT)) continue;
+
+            for (size_t i = 0; i < sigs.size(); i ++) if (sigs[i] == sig) found = true;
+            if (found) continue;
+
+            sigs.push_back(sig);
+            rv.push_back(m);
+        }
+    }
+
+    return rv;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitVariantParms() -- Emit the parameter list of a method
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitVariantParms(std::ofstream &os, Method *m)
+{
+    bool needComma = false;
+
+    os << "(";
+    if (Len(m->Get_Parms()) == 0) os << "void";
+
+    for (ParmList *pl = First(m->Get_Parms()); More(pl); pl = Next(pl)) {
+        if (needComma) os << ", ";
+        os << cpp_VariantType(pl->elem()->Get_Type()) << pl->elem()->Get_Name();
+        needComma = true;
+    }
+
+    os << ")";
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_VariantCall() -- Get the call of a method that passes its parameters on to a concrete node
+//-------------------------------------------------------------------------------------------------------------------
+static std::string cpp_VariantCall(Method *m)
+{
+    std::string rv = "." + m->Get_Name() + "(";
+    bool needComma = false;
+
+    for (ParmList *pl = First(m->Get_Parms()); More(pl); pl = Next(pl)) {
+        if (needComma) rv += ", ";
+        rv += pl->elem()->Get_Name();
+        needComma = true;
+    }
+
+    return rv + ");";
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitVariantAccess() -- Emit the access specifier for the flags
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitVariantAccess(std::ofstream &os, int flags, int dflt)
+{
+    if (!(flags & (PUBLIC | PROTECTED | PRIVATE))) flags |= dflt;
+
+    if (flags & PUBLIC) os << "public:" << std::endl;
+    else if (flags & PROTECTED) os << "protected:" << std::endl;
+    else os << "private:" << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitVariantStatics() -- Emit the static attributes and methods, which stay with the node that declares them
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitVariantStatics(std::ofstream &os, Node *node)
+{
+    for (AttrList *al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        Attribute *a = al->elem();
+
+        if (!(a->Get_Flags() & STATIC)) continue;
+
+        cpp_EmitVariantAccess(os, a->Get_Flags(), PRIVATE);
+        os << "\tstatic " << cpp_VariantType(a->Get_Type()) << a->Get_Name() << ";" << std::endl << std::endl;
+    }
+
+    for (MethList *ml = First(node->Get_Meths()); More(ml); ml = Next(ml)) {
+        Method *m = ml->elem();
+
+        if (!(m->Get_Flags() & STATIC)) continue;
+
+        cpp_EmitVariantAccess(os, m->Get_Flags(), PUBLIC);
+        os << "\tstatic " << cpp_VariantType(m->Get_Type()) << m->Get_Name();
+        cpp_EmitVariantParms(os, m);
+        os << ";" << std::endl << std::endl;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitVariantConcrete() -- Emit a concrete node as a plain class; its methods are defined after the unions
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitVariantConcrete(std::ofstream &os, Node *node)
+{
+    std::string name = node->Get_Name()->Get_Name();
+    std::vector<Attribute *> attrs;
+    std::vector<Method *> meths = cpp_VariantMeths(node);
+    bool needComma = false;
+
+    cpp_VariantAttrs(node, attrs);
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The " << name << " node" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+
+    os << "class " << name << " {" << std::endl;
+    for (Node *n = node->Get_Parent(); n; n = n->Get_Parent()) {
+        os << "\tfriend class " << n->Get_Name()->Get_Name() << ";" << std::endl;
+    }
+    os << std::endl;
+
+    //
+    // -- the constructor is public, since the node is a value
+    //    ----------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The " << name << " constructor" << std::endl;
+    os << "\t//----------------------------------------------------------------------------------" << std::endl;
+    os << "public:" << std::endl;
+    os << "\texplicit " << name << "(";
+
+    for (size_t i = 0; i < attrs.size(); i ++) {
+        if (attrs[i]->Get_Flags() & NOINIT) continue;
+        if (needComma) os << "," << std::endl << "\t\t";
+        os << cpp_VariantType(attrs[i]->Get_Type()) << "__init__" << attrs[i]->Get_Name();
+        needComma = true;
+    }
+
+    if (!needComma) os << "void";
+    os << ")";
+
+    for (size_t i = 0; i < attrs.size(); i ++) {
+        os << (i ? "," : " :") << std::endl << "\t\t" << attrs[i]->Get_Name() << "(";
+        if (attrs[i]->Get_Flags() & NOINIT) os << attrs[i]->Get_Code();
+        else os << "__init__" << attrs[i]->Get_Name();
+        os << ")";
+    }
+
+    os << " { }" << std::endl << std::endl;
+
+    //
+    // -- with --shm, the Factory() builds the node in the segment in use on the thread
+    //    -----------------------------------------------------------------------------
+    if (options & OPT_SHM) {
+        needComma = false;
+
+        os << "\t//" << std::endl;
+        os << "\t// -- The " << name << " Factory function, which builds the node in the segment in use" << std::endl;
+        os << "\t//----------------------------------------------------------------------------------" << std::endl;
+        os << "public:" << std::endl;
+        os << "\tstatic " << name << " *Factory(";
+
+        for (size_t i = 0; i < attrs.size(); i ++) {
+            if (attrs[i]->Get_Flags() & NOINIT) continue;
+            if (needComma) os << ", ";
+            os << cpp_VariantType(attrs[i]->Get_Type()) << "__init__" << attrs[i]->Get_Name();
+            needComma = true;
+        }
+
+        if (!needComma) os << "void";
+        os << ") {" << std::endl;
+        os << "\t\treturn new (ASTShmSegment::Allocate(sizeof(" << name << "), alignof(" << name << "))) " << name
+                << "(";
+
+        needComma = false;
+        for (size_t i = 0; i < attrs.size(); i ++) {
+            if (attrs[i]->Get_Flags() & NOINIT) continue;
+            if (needComma) os << ", ";
+            os << "__init__" << attrs[i]->Get_Name();
+            needComma = true;
+        }
+
+        os << ");" << std::endl;
+        os << "\t}" << std::endl << std::endl;
+    }
+
+    //
+    // -- the attributes, with those inherited first
+    //    ------------------------------------------
+    for (size_t i = 0; i < attrs.size(); i ++) {
+        Attribute *a = attrs[i];
+
+        os << "\t//" << std::endl;
+        os << "\t// -- The " << a->Get_Name() << " attribute" << std::endl;
+        os << "\t//---------------------------------------------------------------------------------" << std::endl;
+
+        cpp_EmitVariantAccess(os, a->Get_Flags(), PRIVATE);
+        os << "\t" << cpp_VariantField(a->Get_Type()) << a->Get_Name() << ";" << std::endl << std::endl;
+
+        if (a->Get_Flags() & NOINLINES) continue;
+
+        os << "public:" << std::endl;
+        os << "\t" << cpp_VariantType(a->Get_Type()) << "Get_" << a->Get_Name() << "(void) { return "
+                << a->Get_Name() << "; }" << std::endl;
+        os << "\tvoid Set_" << a->Get_Name() << "(" << cpp_VariantType(a->Get_Type()) << "val) { "
+                << a->Get_Name() << " = val; }" << std::endl << std::endl;
+    }
+
+    cpp_EmitVariantStatics(os, node);
+
+    //
+    // -- the methods, including the ones with code that are inherited
+    //    ------------------------------------------------------------
+    for (size_t i = meths.size(); i > 0; i --) {
+        Method *m = meths[i - 1];
+
+        os << "\t//" << std::endl;
+        os << "\t// -- The " << m->Get_Name() << " method" << std::endl;
+        os << "\t//---------------------------------------------------------------------------------" << std::endl;
+
+        cpp_EmitVariantAccess(os, m->Get_Flags(), PUBLIC);
+        os << "\t" << cpp_VariantType(m->Get_Type()) << m->Get_Name();
+        cpp_EmitVariantParms(os, m);
+        os << ";" << std::endl << std::endl;
+    }
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The " << name << " node type" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "public:" << std::endl;
+    os << "\tASTNodeType _GetType(void) const { return NODE_TYPE_" << name << "; }" << std::endl;
+    os << "\tconst char *_GetTypeString(void) const { return \"" << name << "\"; }" << std::endl;
+
+    os << "};" << std::endl;
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitVariantSwitch() -- Emit a switch on the tag that runs the statement on each concrete node.  The last
+//                            case is the default, so that a switch that returns a value always does.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitVariantSwitch(std::ofstream &os, std::vector<Node *> &concretes, const std::string &pre,
+        const std::string &post)
+{
+    os << "\t\tswitch (_tag) {" << std::endl;
+
+    for (size_t i = 0; i < concretes.size(); i ++) {
+        std::string name = concretes[i]->Get_Name()->Get_Name();
+
+        if (i == concretes.size() - 1) os << "\t\tdefault: ";
+        else os << "\t\tcase NODE_TYPE_" << name << ": ";
+
+        os << pre << "_" << name << post << std::endl;
+    }
+
+    os << "\t\t}" << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitVariantUnion() -- Emit an abstract node as a tagged union over its concrete descendants
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitVariantUnion(std::ofstream &os, Node *node)
+{
+    std::string name = node->Get_Name()->Get_Name();
+    std::vector<Node *> concretes = cpp_VariantConcretes(node);
+    std::vector<Attribute *> attrs;
+    std::vector<Method *> meths = cpp_VariantMeths(node);
+
+    cpp_VariantAttrs(node, attrs);
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The " << name << " node, a union over its concrete nodes" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+
+    os << "class " << name << " {" << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The node type tag and the concrete nodes" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "protected:" << std::endl;
+    os << "\tASTNodeType _tag;" << std::endl;
+
+    if (concretes.empty()) {
+        os << std::endl;
+        cpp_EmitVariantStatics(os, node);
+        os << "};" << std::endl;
+        os << std::endl << std::endl;
+        return;
+    }
+
+    os << "\tunion {" << std::endl;
+    for (size_t i = 0; i < concretes.size(); i ++) {
+        os << "\t\t" << concretes[i]->Get_Name()->Get_Name() << " _" << concretes[i]->Get_Name()->Get_Name()
+                << ";" << std::endl;
+    }
+    os << "\t};" << std::endl << std::endl;
+
+    //
+    // -- a union is built from any of its concrete nodes, and copied and destroyed through the tag
+    //    -----------------------------------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The " << name << " constructors" << std::endl;
+    os << "\t//----------------------------------------------------------------------------------" << std::endl;
+    os << "public:" << std::endl;
+
+    for (size_t i = 0; i < concretes.size(); i ++) {
+        std::string c = concretes[i]->Get_Name()->Get_Name();
+
+        os << "\t" << name << "(const " << c << " &n) : _tag(NODE_TYPE_" << c << "), _" << c << "(n) { }" << std::endl;
+        os << "\t" << name << "(" << c << " &&n) : _tag(NODE_TYPE_" << c << "), _" << c << "(std::move(n)) { }"
+                << std::endl;
+    }
+    os << std::endl;
+
+    if (options & OPT_SHM) {
+        os << "\ttemplate <class N> static " << name << " *Factory(const N &n) {" << std::endl;
+        os << "\t\treturn new (ASTShmSegment::Allocate(sizeof(" << name << "), alignof(" << name << "))) " << name
+                << "(n);" << std::endl;
+        os << "\t}" << std::endl << std::endl;
+    }
+
+    os << "\t" << name << "(const " << name << " &o) : _tag(o._tag) {" << std::endl;
+    for (size_t i = 0; i < concretes.size(); i ++) {
+        std::string c = concretes[i]->Get_Name()->Get_Name();
+
+        os << "\t\tif (_tag == NODE_TYPE_" << c << ") new (&_" << c << ") " << c << "(o._" << c << ");" << std::endl;
+    }
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t" << name << "(" << name << " &&o) : _tag(o._tag) {" << std::endl;
+    for (size_t i = 0; i < concretes.size(); i ++) {
+        std::string c = concretes[i]->Get_Name()->Get_Name();
+
+        os << "\t\tif (_tag == NODE_TYPE_" << c << ") new (&_" << c << ") " << c << "(std::move(o._" << c << "));"
+                << std::endl;
+    }
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t" << name << " &operator=(const " << name << " &o) {" << std::endl;
+    os << "\t\tif (this != &o) { this->~" << name << "(); new (this) " << name << "(o); }" << std::endl;
+    os << "\t\treturn *this;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t" << name << " &operator=(" << name << " &&o) {" << std::endl;
+    os << "\t\tif (this != &o) { this->~" << name << "(); new (this) " << name << "(std::move(o)); }" << std::endl;
+    os << "\t\treturn *this;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The " << name << " destructor" << std::endl;
+    os << "\t//--------------------------------------------------------------------------------" << std::endl;
+    os << "public:" << std::endl;
+    os << "\t~" << name << "(void) {" << std::endl;
+    for (size_t i = 0; i < concretes.size(); i ++) {
+        std::string c = concretes[i]->Get_Name()->Get_Name();
+
+        os << "\t\tif (_tag == NODE_TYPE_" << c << ") _" << c << ".~" << c << "();" << std::endl;
+    }
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the node type and the checked access to the concrete nodes
+    //    ----------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- The node type and the concrete nodes" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "public:" << std::endl;
+    os << "\tASTNodeType _GetTag(void) const { return _tag; }" << std::endl;
+    os << "\tASTNodeType _GetType(void) const { return _tag; }" << std::endl;
+    os << "\tconst char *_GetTypeString(void) const {" << std::endl;
+    cpp_EmitVariantSwitch(os, concretes, "return ", "._GetTypeString();");
+    os << "\t}" << std::endl << std::endl;
+
+    for (size_t i = 0; i < concretes.size(); i ++) {
+        std::string c = concretes[i]->Get_Name()->Get_Name();
+
+        os << "\t" << c << " *_As_" << c << "(void) { return _tag == NODE_TYPE_" << c << " ? &_" << c
+                << " : NULL; }" << std::endl;
+    }
+    os << std::endl;
+
+    //
+    // -- the attribute accessors reach the copy of the attribute in the concrete node
+    //    ----------------------------------------------------------------------------
+    for (size_t i = 0; i < attrs.size(); i ++) {
+        Attribute *a = attrs[i];
+
+        if (a->Get_Flags() & NOINLINES) continue;
+
+        os << "\t//" << std::endl;
+        os << "\t// -- The " << a->Get_Name() << " attribute" << std::endl;
+        os << "\t//---------------------------------------------------------------------------------" << std::endl;
+        os << "public:" << std::endl;
+        os << "\t" << cpp_VariantType(a->Get_Type()) << "Get_" << a->Get_Name() << "(void) {" << std::endl;
+        cpp_EmitVariantSwitch(os, concretes, "return ", "." + a->Get_Name() + ";");
+        os << "\t}" << std::endl << std::endl;
+
+        os << "\tvoid Set_" << a->Get_Name() << "(" << cpp_VariantType(a->Get_Type()) << "val) {" << std::endl;
+        cpp_EmitVariantSwitch(os, concretes, "", "." + a->Get_Name() + " = val; break;");
+        os << "\t}" << std::endl << std::endl;
+    }
+
+    cpp_EmitVariantStatics(os, node);
+
+    //
+    // -- the methods dispatch to the concrete nodes, except those without code that are declared here
+    //    --------------------------------------------------------------------------------------------
+    for (size_t i = meths.size(); i > 0; i --) {
+        Method *m = meths[i - 1];
+
+        os << "\t//" << std::endl;
+        os << "\t// -- The " << m->Get_Name() << " method" << std::endl;
+        os << "\t//---------------------------------------------------------------------------------" << std::endl;
+
+        cpp_EmitVariantAccess(os, m->Get_Flags(), PUBLIC);
+        os << "\t" << cpp_VariantType(m->Get_Type()) << m->Get_Name();
+        cpp_EmitVariantParms(os, m);
+
+        if ((m->Get_Flags() & EXTERNAL) && !(m->Get_Flags() & ABSTRACT)) {
+            os << ";" << std::endl << std::endl;
+            continue;
+        }
+
+        os << " {" << std::endl;
+        cpp_EmitVariantSwitch(os, concretes, "return ", cpp_VariantCall(m));
+        os << "\t}" << std::endl << std::endl;
+    }
+
+    os << "};" << std::endl;
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitVariantMethods() -- Emit the methods of the concrete nodes, which need the unions to be complete
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitVariantMethods(std::ofstream &os)
+{
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The methods of the concrete nodes" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+        std::vector<Method *> meths;
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+        meths = cpp_VariantMeths(n);
+
+        for (size_t i = meths.size(); i > 0; i --) {
+            Method *m = meths[i - 1];
+
+            if (m->Get_Flags() & EXTERNAL) continue;
+
+            os << "inline " << cpp_VariantType(m->Get_Type()) << n->Get_Name()->Get_Name() << "::" << m->Get_Name();
+            cpp_EmitVariantParms(os, m);
+            os << " " << m->Get_Code() << std::endl;
+        }
+    }
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        for (MethList *ml = First(n->Get_Meths()); More(ml); ml = Next(ml)) {
+            Method *m = ml->elem();
+
+            if (!(m->Get_Flags() & STATIC) || (m->Get_Flags() & EXTERNAL)) continue;
+
+            os << "inline " << cpp_VariantType(m->Get_Type()) << n->Get_Name()->Get_Name() << "::" << m->Get_Name();
+            cpp_EmitVariantParms(os, m);
+            os << " " << m->Get_Code() << std::endl;
+        }
+    }
+
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitVariant() -- Emit the nodes as plain classes and tagged unions.  The concrete nodes hold the others only
+//                      by pointer, so they are all complete before the unions that hold them.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitVariant(std::ofstream &os)
+{
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// now to emit each of the nodes in turn; the concrete nodes first, then the unions" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << std::endl << std::endl;
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        if (!(nl->elem()->Get_Flags() & ABSTRACT)) cpp_EmitVariantConcrete(os, nl->elem());
+    }
+
+    for (NodeList *nl = First(nodes); More(nl); nl = Next(nl)) {
+        if (nl->elem()->Get_Flags() & ABSTRACT) cpp_EmitVariantUnion(os, nl->elem());
+    }
+
+    cpp_EmitVariantMethods(os);
+}
@@ -0,0 +1,667 @@
+//===================================================================================================================
+// emit-cpp-walk.cc -- This file is responsible for emitting the CPP child slot tables and tree iterators
+//
+//    ast-cc is an Abstract Syntax Tree compiler
+//    Copyright (C) 2014  Adam Clark
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Every node-typed attribute of a node is a child slot.  Since the complete set of attributes is known at
+// generation time, we can emit a table for each concrete node type that lists where its child slots live (as
+// offsets into the object).  With the node type tag stored in the root node, any generic walk can then find the
+// children of a node with a table lookup instead of a virtual call per node type.
+//
+// The iterators that are emitted here keep their own explicit stacks, so the depth of a tree has no impact on
+// the depth of the program stack.  The parallel walk is built the same way, with the pending subtrees shared
+// between threads.
+//
+// -----------------------------------------------------------------------------------------------------------------
+//
+//    Date     Tracker  Version  Pgmr  Modification
+// ----------  -------  -------  ----  -----------------------------------------------------------------------------
+// 2026-10-18    N/A    v0.1.1   ADCL  Initial version
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the parallel work-stealing walk
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the parent links
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the slot index, the declared slot type and the uniform child access
+// 2026-10-18    N/A    v0.1.1   ADCL  Add _WithChild() for immutable nodes
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the iterative destruction of owned children
+// 2026-10-18    N/A    v0.1.1   ADCL  Park the idle workers of the parallel walk on a condition variable
+//
+//===================================================================================================================
+
+#include "lists.hh"
+#include "ast-cc.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitChildSlots() -- Emit the offsets of the child slots for a node, starting with those inherited
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitChildSlots(std::ofstream &os, Node *node, Node *concrete)
+{
+    if (!node) return;
+
+    cpp_EmitChildSlots(os, node->Get_Parent(), concrete);
+
+    AttrList *al;
+
+    for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        Attribute *a = al->elem();
+
+        if (!a->Is_Child()) continue;
+        os << "\t\t\t{ offsetof(" << concrete->Get_Name()->Get_Name() << ", " << a->Get_Name() << "), \""
+                << a->Get_Type()->Get_Name() << "\", " << (a->Get_Flags()&OWNED?"true":"false") << " }," << std::endl;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitChildTables() -- Emit the child slot tables for all concrete nodes
+//
+// The tables are emitted as members of ASTNodeMeta, which every node names as a friend so that the offsets of
+// protected and private attributes can be taken.  offsetof() on a class with virtual functions is only
+// conditionally supported by the standard, but g++ and clang both handle single inheritance properly; the
+// warning is suppressed around the tables.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitChildTables(std::ofstream &os)
+{
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+    NodeList *nl;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The child slot tables locate the node-typed attributes of each node type by offset" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "struct ASTChildSlot {" << std::endl;
+    os << "\tsize_t offset;" << std::endl;
+    os << "\tconst char *type;" << std::endl;
+    os << "\tbool owned;" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "struct ASTChildTable {" << std::endl;
+    os << "\tconst ASTChildSlot *slots;" << std::endl;
+    os << "\tint count;" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "#if defined(__GNUC__)" << std::endl;
+    os << "#pragma GCC diagnostic push" << std::endl;
+    os << "#pragma GCC diagnostic ignored \"-Winvalid-offsetof\"" << std::endl;
+    os << "#endif" << std::endl << std::endl;
+
+    os << "struct ASTNodeMeta {" << std::endl;
+
+    //
+    // -- The table lookup, indexed by the node type tag
+    //    ----------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Get the child slot table for a node type" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic const ASTChildTable &ChildTable(ASTNodeType t) {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+        if (n->GetChildCount() == 0) continue;
+
+        os << "\t\tstatic const ASTChildSlot " << n->Get_Name()->Get_Name() << "_slots[] = {" << std::endl;
+        cpp_EmitChildSlots(os, n, n);
+        os << "\t\t};" << std::endl << std::endl;
+    }
+
+    os << "\t\tstatic const ASTChildTable tables[] = {" << std::endl;
+
+    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+        Node *n = nl->elem();
+
+        if (n->Get_Flags() & ABSTRACT) continue;
+        if (n->GetChildCount() == 0) os << "\t\t\t{ NULL, 0 }," << std::endl;
+        else os << "\t\t\t{ " << n->Get_Name()->Get_Name() << "_slots, " << n->GetChildCount() << " }," << std::endl;
+    }
+
+    os << "\t\t};" << std::endl << std::endl;
+    os << "\t\treturn tables[t];" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- The slot accessors.  The slots hold pointers to some class derived from the root, which has the same
+    //    representation as a pointer to the root with single inheritance.  memcpy() keeps the compiler from
+    //    making aliasing assumptions about the different pointer types.
+    //    ----------------------------------------------------------------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Read and write a child slot" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "\tstatic " << root << " *GetSlot(const " << root << " *n, const ASTChildSlot &s) {" << std::endl;
+    os << "\t\t" << root << " *rv;" << std::endl;
+    os << "\t\tstd::memcpy(&rv, reinterpret_cast<const char *>(n) + s.offset, sizeof(rv));" << std::endl;
+    os << "\t\treturn rv;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstatic void SetSlot(" << root << " *n, const ASTChildSlot &s, " << root << " *c) {" << std::endl;
+
+    if (NeedParentLinks()) {
+        os << "\t\t" << root << " *o = GetSlot(n, s);" << std::endl << std::endl;
+        os << "\t\tif (o && o->_parent == n) {" << std::endl;
+        os << "\t\t\to->_parent = NULL;" << std::endl;
+        os << "\t\t\to->_slot = -1;" << std::endl;
+        os << "\t\t}" << std::endl << std::endl;
+        os << "\t\tstd::memcpy(reinterpret_cast<char *>(n) + s.offset, &c, sizeof(c));" << std::endl;
+        os << "\t\tif (c) {" << std::endl;
+        os << "\t\t\tc->_parent = n;" << std::endl;
+        os << "\t\t\tc->_slot = (int)(&s - ChildTable(n->_tag).slots);" << std::endl;
+        os << "\t\t}" << std::endl << std::endl;
+        os << "\t\tn->_Invalidate();" << std::endl;
+        os << "\t}" << std::endl << std::endl;
+
+        os << "\tstatic void SetParent(" << root << " *n, " << root << " *p) {" << std::endl;
+        os << "\t\tn->_parent = p;" << std::endl;
+        os << "\t\tif (p) p->_Invalidate();" << std::endl;
+        os << "\t}" << std::endl;
+    } else {
+        os << "\t\tstd::memcpy(reinterpret_cast<char *>(n) + s.offset, &c, sizeof(c));" << std::endl;
+        os << "\t}" << std::endl;
+    }
+
+    if (HasOwnedAttrs()) {
+        os << std::endl;
+        os << "\tstatic " << root << " *TakeSlot(" << root << " *n, const ASTChildSlot &s) {" << std::endl;
+        os << "\t\t" << root << " *rv = GetSlot(n, s);" << std::endl;
+        os << "\t\t" << root << " *c = NULL;" << std::endl << std::endl;
+        os << "\t\tstd::memcpy(reinterpret_cast<char *>(n) + s.offset, &c, sizeof(c));" << std::endl;
+        os << "\t\treturn rv;" << std::endl;
+        os << "\t}" << std::endl;
+    }
+
+    os << "};" << std::endl << std::endl;
+
+    os << "#if defined(__GNUC__)" << std::endl;
+    os << "#pragma GCC diagnostic pop" << std::endl;
+    os << "#endif" << std::endl;
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitParentLinks() -- Emit the root node members that maintain the parent links through the child slots
+//
+// These have to wait for the child slot tables, so they are declared inline in the root node and defined here.
+// The child slots are numbered the same way in all of the tables that share them, so the setter of a child
+// attribute can name its slot by index no matter what the concrete type of the node is.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitParentLinks(std::ofstream &os)
+{
+    if (!NeedParentLinks()) return;
+
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The parent links are kept up to date through the child slots" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "inline void " << root << "::_AdoptChildren(void) {" << std::endl;
+    os << "\tconst ASTChildTable &t = ASTNodeMeta::ChildTable(_tag);" << std::endl << std::endl;
+    os << "\tfor (int i = 0; i < t.count; i ++) {" << std::endl;
+    os << "\t\t" << root << " *c = ASTNodeMeta::GetSlot(this, t.slots[i]);" << std::endl;
+    os << "\t\tif (c) {" << std::endl;
+    os << "\t\t\tc->_parent = this;" << std::endl;
+    os << "\t\t\tc->_slot = i;" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline void " << root << "::_AdoptSlot(int i) {" << std::endl;
+    os << "\t" << root << " *c = ASTNodeMeta::GetSlot(this, ASTNodeMeta::ChildTable(_tag).slots[i]);" << std::endl << std::endl;
+    os << "\tif (c) {" << std::endl;
+    os << "\t\tc->_parent = this;" << std::endl;
+    os << "\t\tc->_slot = i;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+    os << "\t_Invalidate();" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline void " << root << "::_ReleaseSlot(int i) {" << std::endl;
+    os << "\t" << root << " *c = ASTNodeMeta::GetSlot(this, ASTNodeMeta::ChildTable(_tag).slots[i]);" << std::endl << std::endl;
+    os << "\tif (c && c->_parent == this) {" << std::endl;
+    os << "\t\tc->_parent = NULL;" << std::endl;
+    os << "\t\tc->_slot = -1;" << std::endl;
+    os << "\t}" << std::endl;
+    os << "}" << std::endl;
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitOwnership() -- Emit the iterative destruction of the owned children
+//
+// The destructor of each concrete node with owned children calls _DestroyOwned() with its own type, which takes
+// the owned children out of their slots and onto a worklist.  Each node on the worklist has its own owned children
+// taken the same way before it is deleted, so its destructor finds nothing left to do.  No destructor ever
+// recurses, and a tree of any depth is destroyed with one worklist in time linear in its size.  ASTRelease() does
+// the same walk but hands each node to a function of the caller's choosing (to return it to a pool, say).
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitOwnership(std::ofstream &os)
+{
+    if (!HasOwnedAttrs()) return;
+
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The owned children are destroyed with a worklist rather than by recursion" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class Release>" << std::endl;
+    os << "inline void ASTRelease(" << root << " *tree, Release release) {" << std::endl;
+    os << "\tstd::vector<" << root << " *> work;" << std::endl << std::endl;
+    os << "\tif (tree) work.push_back(tree);" << std::endl << std::endl;
+    os << "\twhile (!work.empty()) {" << std::endl;
+    os << "\t\t" << root << " *n = work.back();" << std::endl;
+    os << "\t\tconst ASTChildTable &t = ASTNodeMeta::ChildTable(n->_GetTag());" << std::endl << std::endl;
+    os << "\t\twork.pop_back();" << std::endl;
+    os << "\t\tfor (int i = 0; i < t.count; i ++) {" << std::endl;
+    os << "\t\t\tif (!t.slots[i].owned) continue;" << std::endl << std::endl;
+    os << "\t\t\t" << root << " *c = ASTNodeMeta::TakeSlot(n, t.slots[i]);" << std::endl;
+    os << "\t\t\tif (c) work.push_back(c);" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\trelease(n);" << std::endl;
+    os << "\t}" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline void " << root << "::_DestroyOwned(ASTNodeType type) {" << std::endl;
+    os << "\tconst ASTChildTable &t = ASTNodeMeta::ChildTable(type);" << std::endl << std::endl;
+    os << "\tfor (int i = 0; i < t.count; i ++) {" << std::endl;
+    os << "\t\tif (!t.slots[i].owned) continue;" << std::endl << std::endl;
+    os << "\t\t" << root << " *c = ASTNodeMeta::TakeSlot(this, t.slots[i]);" << std::endl;
+    os << "\t\tif (c) ASTRelease(c, [](" << root << " *n) { delete n; });" << std::endl;
+    os << "\t}" << std::endl;
+    os << "}" << std::endl;
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitWithChildCases() -- Emit the with_ call for each child slot of an immutable node, by slot index
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitWithChildCases(std::ofstream &os, Node *node, Node *concrete, int &slot)
+{
+    if (!node) return;
+
+    cpp_EmitWithChildCases(os, node->Get_Parent(), concrete, slot);
+
+    AttrList *al;
+
+    for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        Attribute *a = al->elem();
+
+        if (!a->Is_Child()) continue;
+        os << "\t\tcase " << slot ++ << ": return static_cast<" << concrete->Get_Name()->Get_Name() << " *>(this)->with_"
+                << a->Get_Name() << "(static_cast<" << a->Get_Type()->Get_Name() << " *>(n));" << std::endl;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitChildAccess() -- Emit the root node members that reach the children by child slot index
+//
+// When there are immutable nodes, _WithChild() replaces a child the way that suits the node: an immutable node is
+// copied with its with_ function (and the copy is returned) while any other node is updated in place.  There is
+// no _ReplaceChild() then, since it would write through the const child pointers of an immutable node.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitChildAccess(std::ofstream &os)
+{
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// Uniform access to the children of any node through the child slot tables" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "inline int " << root << "::_ChildCount(void) const {" << std::endl;
+    os << "\treturn ASTNodeMeta::ChildTable(_tag).count;" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    os << "inline " << root << " *" << root << "::_Child(int i) const {" << std::endl;
+    os << "\treturn ASTNodeMeta::GetSlot(this, ASTNodeMeta::ChildTable(_tag).slots[i]);" << std::endl;
+    os << "}" << std::endl << std::endl;
+
+    if (!HasImmutableNodes()) {
+        os << "inline " << root << " *" << root << "::_ReplaceChild(int i, " << root << " *n) {" << std::endl;
+        os << "\tconst ASTChildSlot &s = ASTNodeMeta::ChildTable(_tag).slots[i];" << std::endl;
+        os << "\t" << root << " *rv = ASTNodeMeta::GetSlot(this, s);" << std::endl << std::endl;
+        os << "\tASTNodeMeta::SetSlot(this, s, n);" << std::endl;
+        os << "\treturn rv;" << std::endl;
+        os << "}" << std::endl;
+    } else {
+        NodeList *nl;
+
+        os << "inline " << root << " *" << root << "::_WithChild(int i, " << root << " *n) {" << std::endl;
+        os << "\tswitch (_tag) {" << std::endl;
+
+        for (nl = First(nodes); More(nl); nl = Next(nl)) {
+            Node *nd = nl->elem();
+            int slot = 0;
+
+            if (!(nd->Get_Flags() & IMMUTABLE) || (nd->Get_Flags() & ABSTRACT)) continue;
+            if (nd->GetChildCount() == 0) continue;
+
+            os << "\tcase NODE_TYPE_" << nd->Get_Name()->Get_Name() << ":" << std::endl;
+            os << "\t\tswitch (i) {" << std::endl;
+            cpp_EmitWithChildCases(os, nd, nd, slot);
+            os << "\t\t}" << std::endl;
+            os << "\t\tbreak;" << std::endl << std::endl;
+        }
+
+        os << "\tdefault:" << std::endl;
+        os << "\t\tbreak;" << std::endl;
+        os << "\t}" << std::endl << std::endl;
+        os << "\tASTNodeMeta::SetSlot(this, ASTNodeMeta::ChildTable(_tag).slots[i], n);" << std::endl;
+        os << "\treturn this;" << std::endl;
+        os << "}" << std::endl;
+    }
+
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitIteratorClass() -- Emit the nested iterator class used for range-for on a walk
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitIteratorClass(std::ofstream &os, const std::string &walk, const std::string &root)
+{
+    os << "public:" << std::endl;
+    os << "\tclass iterator {" << std::endl;
+    os << "\tprivate:" << std::endl;
+    os << "\t\t" << walk << " *walk;" << std::endl << std::endl;
+    os << "\tpublic:" << std::endl;
+    os << "\t\texplicit iterator(" << walk << " *w) : walk(w) { }" << std::endl;
+    os << "\t\t" << root << " *operator*(void) const { return walk->current; }" << std::endl;
+    os << "\t\titerator &operator++(void) { walk->Next(); return *this; }" << std::endl;
+    os << "\t\tbool operator!=(const iterator &o) const {" << std::endl;
+    os << "\t\t\treturn (walk?walk->current:NULL) != (o.walk?o.walk->current:NULL);" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    os << "\titerator begin(void) { return iterator(this); }" << std::endl;
+    os << "\titerator end(void) { return iterator(NULL); }" << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitIterators() -- Emit the preorder and postorder tree iterators
+//
+// Both iterators are usable with range-for:
+//
+//      ASTPreorder walk(tree);
+//      for (Common *n : walk) { if (...) walk.SkipChildren(); }
+//
+// The preorder walk keeps a stack of the nodes still to be visited.  The postorder walk keeps a stack of frames
+// (node and next child slot), which is bounded by the depth of the tree.  Since a postorder walk visits the
+// children before the parent, subtrees are pruned there with a predicate given at construction.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitIterators(std::ofstream &os)
+{
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+
+    //
+    // -- The preorder iterator
+    //    ---------------------
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTPreorder -- walk a tree in preorder with an explicit stack; SkipChildren() prunes a subtree" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "class ASTPreorder {" << std::endl;
+    os << "private:" << std::endl;
+    os << "\tstd::vector<" << root << " *> stack;" << std::endl;
+    os << "\t" << root << " *current;" << std::endl;
+    os << "\tbool skip;" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\texplicit ASTPreorder(" << root << " *tree) : current(tree), skip(false) { }" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\t" << root << " *Current(void) const { return current; }" << std::endl;
+    os << "\tvoid SkipChildren(void) { skip = true; }" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tvoid Next(void) {" << std::endl;
+    os << "\t\tif (current && !skip) {" << std::endl;
+    os << "\t\t\tconst ASTChildTable &t = ASTNodeMeta::ChildTable(current->_GetTag());" << std::endl << std::endl;
+    os << "\t\t\tfor (int i = t.count - 1; i >= 0; i --) {" << std::endl;
+    os << "\t\t\t\t" << root << " *c = ASTNodeMeta::GetSlot(current, t.slots[i]);" << std::endl;
+    os << "\t\t\t\tif (c) stack.push_back(c);" << std::endl;
+    os << "\t\t\t}" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tskip = false;" << std::endl;
+    os << "\t\tif (stack.empty()) current = NULL;" << std::endl;
+    os << "\t\telse { current = stack.back(); stack.pop_back(); }" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    cpp_EmitIteratorClass(os, "ASTPreorder", root);
+
+    os << "};" << std::endl << std::endl << std::endl;
+
+    //
+    // -- The postorder iterator
+    //    ----------------------
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTPostorder -- walk a tree in postorder with an explicit stack; the prune function (if any)" << std::endl;
+    os << "//                 returns true for nodes that are visited without visiting their children" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "typedef bool (*ASTPruneFunc)(" << root << " *node);" << std::endl << std::endl;
+
+    os << "class ASTPostorder {" << std::endl;
+    os << "private:" << std::endl;
+    os << "\tstruct Frame {" << std::endl;
+    os << "\t\t" << root << " *node;" << std::endl;
+    os << "\t\tconst ASTChildTable *table;" << std::endl;
+    os << "\t\tint next;" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+    os << "\tstd::vector<Frame> stack;" << std::endl;
+    os << "\t" << root << " *current;" << std::endl;
+    os << "\tASTPruneFunc prune;" << std::endl << std::endl;
+
+    os << "private:" << std::endl;
+    os << "\tvoid Push(" << root << " *n) {" << std::endl;
+    os << "\t\tFrame f = { n, &ASTNodeMeta::ChildTable(n->_GetTag()), 0 };" << std::endl;
+    os << "\t\tif (prune && prune(n)) f.next = f.table->count;" << std::endl;
+    os << "\t\tstack.push_back(f);" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\texplicit ASTPostorder(" << root << " *tree, ASTPruneFunc p = NULL) : current(NULL), prune(p) {" << std::endl;
+    os << "\t\tif (tree) Push(tree);" << std::endl;
+    os << "\t\tNext();" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\t" << root << " *Current(void) const { return current; }" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tvoid Next(void) {" << std::endl;
+    os << "\t\twhile (!stack.empty()) {" << std::endl;
+    os << "\t\t\tFrame &f = stack.back();" << std::endl << std::endl;
+    os << "\t\t\tif (f.next < f.table->count) {" << std::endl;
+    os << "\t\t\t\t" << root << " *c = ASTNodeMeta::GetSlot(f.node, f.table->slots[f.next ++]);" << std::endl;
+    os << "\t\t\t\tif (c) Push(c);" << std::endl;
+    os << "\t\t\t\tcontinue;" << std::endl;
+    os << "\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\tcurrent = f.node;" << std::endl;
+    os << "\t\t\tstack.pop_back();" << std::endl;
+    os << "\t\t\treturn;" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tcurrent = NULL;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    cpp_EmitIteratorClass(os, "ASTPostorder", root);
+
+    os << "};" << std::endl << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitParallel() -- Emit the parallel work-stealing walk (--parallel only)
+//
+// Each worker thread owns a deque of subtrees.  A task walks its subtree with an explicit stack like ASTPreorder;
+// once it has visited `grain` nodes and its own deque has run dry, it hands all but the most recent of its pending
+// subtrees to its deque.  The owner takes work from the back of its deque and idle workers steal from the front,
+// where the oldest (and therefore largest) subtrees are.  The grain counts the nodes a task has visited since it
+// last split, not the size of the subtrees it hands off, which are not known without walking them.  A worker that
+// finds no work parks on a condition variable, which Push() signals (and the last task to finish, to end the walk).
+//
+// The Visitor supplies the work and the reduction:
+//
+//      struct V {
+//          typedef long Result;                                // default constructed as the identity
+//          bool Visit(Common *n, Result &acc);                 // return false to skip the children of n
+//          void Reduce(Result &acc, const Result &other);      // must be associative and commutative
+//      };
+//
+// Visit() is called concurrently from all the workers, each with its own accumulator.
+//-------------------------------------------------------------------------------------------------------------------
+void cpp_EmitParallel(std::ofstream &os)
+{
+    if (!(options & OPT_PARALLEL)) return;
+
+    std::string root = GetRootNode()->Get_Name()->Get_Name();
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTParallelWalk -- visit every node of a tree from a pool of work-stealing threads" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class Visitor>" << std::endl;
+    os << "class ASTParallelWalk {" << std::endl;
+    os << "public:" << std::endl;
+    os << "\ttypedef typename Visitor::Result Result;" << std::endl << std::endl;
+
+    os << "private:" << std::endl;
+    os << "\tstruct Worker {" << std::endl;
+    os << "\t\tstd::mutex lock;" << std::endl;
+    os << "\t\tstd::deque<" << root << " *> tasks;" << std::endl;
+    os << "\t\tResult result;" << std::endl;
+    os << "\t\tchar pad[64];" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    os << "\tVisitor &visitor;" << std::endl;
+    os << "\tsize_t grain;" << std::endl;
+    os << "\tstd::vector<Worker> workers;" << std::endl;
+    os << "\tstd::atomic<long> outstanding;" << std::endl;
+    os << "\tstd::mutex idleLock;" << std::endl;
+    os << "\tstd::condition_variable idle;" << std::endl;
+    os << "\tunsigned long pushes;" << std::endl << std::endl;
+
+    os << "private:" << std::endl;
+    os << "\tASTParallelWalk(Visitor &v, size_t g, unsigned n) : visitor(v), grain(g), workers(n), outstanding(0), pushes(0) { }" << std::endl << std::endl;
+
+    //
+    // -- the deque operations
+    //    --------------------
+    os << "private:" << std::endl;
+    os << "\tvoid Push(unsigned self, " << root << " *n) {" << std::endl;
+    os << "\t\toutstanding ++;" << std::endl;
+    os << "\t\t{" << std::endl;
+    os << "\t\t\tstd::lock_guard<std::mutex> g(workers[self].lock);" << std::endl;
+    os << "\t\t\tworkers[self].tasks.push_back(n);" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\tstd::lock_guard<std::mutex> g(idleLock);" << std::endl;
+    os << "\t\tpushes ++;" << std::endl;
+    os << "\t\tidle.notify_one();" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tbool Pop(unsigned self, " << root << " *&n) {" << std::endl;
+    os << "\t\tstd::lock_guard<std::mutex> g(workers[self].lock);" << std::endl;
+    os << "\t\tif (workers[self].tasks.empty()) return false;" << std::endl;
+    os << "\t\tn = workers[self].tasks.back();" << std::endl;
+    os << "\t\tworkers[self].tasks.pop_back();" << std::endl;
+    os << "\t\treturn true;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tbool Steal(unsigned self, " << root << " *&n) {" << std::endl;
+    os << "\t\tfor (size_t i = 1; i < workers.size(); i ++) {" << std::endl;
+    os << "\t\t\tWorker &w = workers[(self + i) % workers.size()];" << std::endl;
+    os << "\t\t\tstd::lock_guard<std::mutex> g(w.lock);" << std::endl << std::endl;
+    os << "\t\t\tif (w.tasks.empty()) continue;" << std::endl;
+    os << "\t\t\tn = w.tasks.front();" << std::endl;
+    os << "\t\t\tw.tasks.pop_front();" << std::endl;
+    os << "\t\t\treturn true;" << std::endl;
+    os << "\t\t}" << std::endl << std::endl;
+    os << "\t\treturn false;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tbool Hungry(unsigned self) {" << std::endl;
+    os << "\t\tstd::lock_guard<std::mutex> g(workers[self].lock);" << std::endl;
+    os << "\t\treturn workers[self].tasks.empty();" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- walk a single task
+    //    ------------------
+    os << "private:" << std::endl;
+    os << "\tvoid RunTask(unsigned self, " << root << " *tree) {" << std::endl;
+    os << "\t\tstd::vector<" << root << " *> stack;" << std::endl;
+    os << "\t\tResult &acc = workers[self].result;" << std::endl;
+    os << "\t\tsize_t count = 0;" << std::endl << std::endl;
+    os << "\t\tstack.push_back(tree);" << std::endl << std::endl;
+    os << "\t\twhile (!stack.empty()) {" << std::endl;
+    os << "\t\t\t" << root << " *n = stack.back();" << std::endl;
+    os << "\t\t\tstack.pop_back();" << std::endl << std::endl;
+    os << "\t\t\tif (!visitor.Visit(n, acc)) continue;" << std::endl << std::endl;
+    os << "\t\t\tconst ASTChildTable &t = ASTNodeMeta::ChildTable(n->_GetTag());" << std::endl;
+    os << "\t\t\tfor (int i = t.count - 1; i >= 0; i --) {" << std::endl;
+    os << "\t\t\t\t" << root << " *c = ASTNodeMeta::GetSlot(n, t.slots[i]);" << std::endl;
+    os << "\t\t\t\tif (c) stack.push_back(c);" << std::endl;
+    os << "\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\tif (++ count >= grain && stack.size() > 1 && Hungry(self)) {" << std::endl;
+    os << "\t\t\t\tfor (size_t i = 0; i < stack.size() - 1; i ++) Push(self, stack[i]);" << std::endl;
+    os << "\t\t\t\tstack.erase(stack.begin(), stack.end() - 1);" << std::endl;
+    os << "\t\t\t\tcount = 0;" << std::endl;
+    os << "\t\t\t}" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tvoid Work(unsigned self) {" << std::endl;
+    os << "\t\t" << root << " *n;" << std::endl << std::endl;
+    os << "\t\twhile (outstanding.load() > 0) {" << std::endl;
+    os << "\t\t\tunsigned long seen;" << std::endl << std::endl;
+    os << "\t\t\t{" << std::endl;
+    os << "\t\t\t\tstd::lock_guard<std::mutex> g(idleLock);" << std::endl;
+    os << "\t\t\t\tseen = pushes;" << std::endl;
+    os << "\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\tif (Pop(self, n) || Steal(self, n)) {" << std::endl;
+    os << "\t\t\t\tRunTask(self, n);" << std::endl;
+    os << "\t\t\t\tif (-- outstanding == 0) {" << std::endl;
+    os << "\t\t\t\t\tstd::lock_guard<std::mutex> g(idleLock);" << std::endl;
+    os << "\t\t\t\t\tidle.notify_all();" << std::endl;
+    os << "\t\t\t\t}" << std::endl;
+    os << "\t\t\t\tcontinue;" << std::endl;
+    os << "\t\t\t}" << std::endl << std::endl;
+    os << "\t\t\t// -- park until something is pushed after the deques were found empty, or the walk is done" << std::endl;
+    os << "\t\t\tstd::unique_lock<std::mutex> g(idleLock);" << std::endl;
+    os << "\t\t\tidle.wait(g, [&] { return pushes != seen || outstanding.load() == 0; });" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    //
+    // -- the entry point
+    //    ---------------
+    os << "public:" << std::endl;
+    os << "\tstatic Result Run(" << root << " *tree, Visitor &v, size_t grain = 4096, unsigned threads = 0) {" << std::endl;
+    os << "\t\tif (threads == 0) threads = std::thread::hardware_concurrency();" << std::endl;
+    os << "\t\tif (threads == 0) threads = 1;" << std::endl;
+    os << "\t\tif (grain == 0) grain = 1;" << std::endl << std::endl;
+    os << "\t\tASTParallelWalk walk(v, grain, threads);" << std::endl;
+    os << "\t\tstd::vector<std::thread> pool;" << std::endl << std::endl;
+    os << "\t\tif (tree) walk.Push(0, tree);" << std::endl;
+    os << "\t\tfor (unsigned i = 1; i < threads; i ++) pool.push_back(std::thread(&ASTParallelWalk::Work, &walk, i));" << std::endl;
+    os << "\t\twalk.Work(0);" << std::endl;
+    os << "\t\tfor (size_t i = 0; i < pool.size(); i ++) pool[i].join();" << std::endl << std::endl;
+    os << "\t\tfor (unsigned i = 1; i < threads; i ++) v.Reduce(walk.workers[0].result, walk.workers[i].result);" << std::endl;
+    os << "\t\treturn walk.workers[0].result;" << std::endl;
+    os << "\t}" << std::endl;
+
+    os << "};" << std::endl << std::endl << std::endl;
+}
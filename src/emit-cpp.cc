@@ -34,6 +34,33 @@
 // 2016-09-27   #299     v0.1    ADCL  The constructor parameters are const, but that is not really accurate.
 //                                     Removing the const qualifier.
 // 2016-09-27   #300     v0.1    ADCL  Cleaning up some spacing.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit a stored node type tag and the child slot tables and tree iterators.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the parallel walk when requested.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the rewrite rule matcher.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit computed attributes and the parent links that invalidate them.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the uniform child access and the slot index in the parent.
+// 2026-10-18    N/A    v0.1.1   ADCL  Count the nodes created and destroyed when requested.
+// 2026-10-18    N/A    v0.1.1   ADCL  Trace the method calls when requested.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit immutable nodes with their with_ functions.
+// 2026-10-18    N/A    v0.1.1   ADCL  Destroy the owned children from the destructors.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the nodes as plain classes and tagged unions when requested.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the reflection tables.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the intern tables for interned attributes and the location type.
+// 2026-10-18    N/A    v0.1.1   ADCL  Pack the bits(N) attributes into one word per node.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the flattened postorder form of the node families.
+// 2026-10-18    N/A    v0.1.1   ADCL  Number the nodes and emit the side tables when requested.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit lazy attributes, evaluated by their getters.
+// 2026-10-18    N/A    v0.1.1   ADCL  Register the new nodes with the node index when requested.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the constexpr constructors of the literal nodes and the literal trees.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the tree dumper and reader when requested.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the cached subtree digests when requested.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the iterative clones when requested.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the leaf nodes and overrides final and the non-virtual methods.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the shared memory segments for the variant nodes when requested.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the input stamp in the header, which is checked to skip a rerun.
+// 2026-10-18    N/A    v0.1.1   ADCL  Write the output to a temporary file and rename it over the output.
+// 2026-10-18    N/A    v0.1.1   ADCL  Emit the classes in the order the nodes were declared.
+// 2026-10-18    N/A    v0.1.1   ADCL  Include <condition_variable> for the parallel walk.
 //
 //===================================================================================================================
 
@@ -44,6 +71,35 @@
 #include <cstring>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+
+
+extern void cpp_EmitChildTables(std::ofstream &os);
+extern void cpp_EmitIterators(std::ofstream &os);
+extern void cpp_EmitParallel(std::ofstream &os);
+extern void cpp_EmitRewriter(std::ofstream &os);
+extern void cpp_EmitParentLinks(std::ofstream &os);
+extern void cpp_EmitChildAccess(std::ofstream &os);
+extern void cpp_EmitOwnership(std::ofstream &os);
+extern void cpp_EmitVariant(std::ofstream &os);
+extern void cpp_EmitShmTypes(std::ofstream &os);
+extern void cpp_EmitShm(std::ofstream &os);
+extern void cpp_EmitReflection(std::ofstream &os);
+extern void cpp_EmitFlatten(std::ofstream &os);
+extern void cpp_EmitIds(std::ofstream &os);
+extern void cpp_EmitSideTable(std::ofstream &os);
+extern void cpp_EmitIndex(std::ofstream &os);
+extern void cpp_EmitLiterals(std::ofstream &os);
+extern void cpp_EmitDump(std::ofstream &os);
+extern void cpp_EmitDigestTypes(std::ofstream &os);
+extern void cpp_EmitDigest(std::ofstream &os);
+extern void cpp_EmitClone(std::ofstream &os);
+extern void cpp_EmitStats(std::ofstream &os);
+extern void cpp_EmitStatsTables(std::ofstream &os);
+extern void cpp_EmitTrace(std::ofstream &os);
+extern void cpp_EmitTraceTables(std::ofstream &os);
+extern bool cpp_IsTraced(Method *m);
+extern std::string cpp_TraceId(Node *node, Method *m);
 
 
 //-------------------------------------------------------------------------------------------------------------------
@@ -61,6 +117,8 @@ static void cpp_EmitHeader(std::ofstream &os)
     os << "//" << std::endl;
     os << "// Do not modify this file directly as your changes will likely be lost." << std::endl;
     os << "//" << std::endl;
+    os << InputStamp() << std::endl;
+    os << "//" << std::endl;
     os << "//===============================================================================================" << std::endl;
     os << std::endl << std::endl;
 }
@@ -85,6 +143,13 @@ static void cpp_EmitForwards(std::ofstream &os)
         }
     }
 
+    os << "struct ASTNodeMeta;" << std::endl;
+    os << "template <class T> struct ASTReflect;" << std::endl;
+    if (HasFlatNodes()) os << "template <class T> class ASTFlat;" << std::endl;
+    if (HasLiteralNodes()) os << "struct ASTLiteral { };" << std::endl;
+    if (options & OPT_DUMP) os << "struct ASTDumpAccess;" << std::endl;
+    if (options & OPT_DIGEST) os << "struct ASTDigestAccess;" << std::endl;
+    if (options & OPT_CLONE) os << "struct ASTCloneAccess;" << std::endl;
     os << std::endl << std::endl;
 }
 
@@ -104,6 +169,190 @@ static void cpp_EmitIncludes(std::ofstream &os)
         os << "#include " << l->elem() << std::endl;
     }
 
+    //
+    // -- These are needed by the generated support code (child tables and iterators)
+    //    ---------------------------------------------------------------------------
+    os << "#include <cstddef>" << std::endl;
+    os << "#include <cstring>" << std::endl;
+    os << "#include <vector>" << std::endl;
+
+    if (options & OPT_PARALLEL) {
+        os << "#include <atomic>" << std::endl;
+        os << "#include <condition_variable>" << std::endl;
+        os << "#include <deque>" << std::endl;
+        os << "#include <mutex>" << std::endl;
+        os << "#include <thread>" << std::endl;
+    }
+
+    if (options & OPT_IDS) {
+        os << "#include <atomic>" << std::endl;
+        os << "#include <mutex>" << std::endl;
+    }
+
+    if (options & OPT_DUMP) {
+        os << "#include <cstdio>" << std::endl;
+        os << "#include <cstdlib>" << std::endl;
+        os << "#include <string>" << std::endl;
+        os << "#include <type_traits>" << std::endl;
+    }
+
+    if (options & OPT_DIGEST) {
+        os << "#include <cstdint>" << std::endl;
+        os << "#include <string>" << std::endl;
+        os << "#include <type_traits>" << std::endl;
+    }
+
+    if (options & OPT_CLONE) {
+        os << "#include <new>" << std::endl;
+    }
+
+    if (options & OPT_INDEX) {
+        os << "#if defined(__SSE2__) && defined(__GNUC__) && !defined(AST_INDEX_SCALAR)" << std::endl;
+        os << "#include <emmintrin.h>" << std::endl;
+        os << "#endif" << std::endl;
+    }
+
+    if (HasLazyAttrs() && HasImmutableNodes()) {
+        os << "#include <mutex>" << std::endl;
+    }
+
+    if (rewrites && HasOwnedAttrs() && !HasImmutableNodes()) {
+        os << "#include <unordered_set>" << std::endl;
+    }
+
+    if (options & OPT_VARIANT) {
+        os << "#include <new>" << std::endl;
+        os << "#include <utility>" << std::endl;
+    }
+
+    if (options & OPT_SHM) {
+        os << "#include <cstdint>" << std::endl;
+        os << "#include <type_traits>" << std::endl;
+        os << "#include <fcntl.h>" << std::endl;
+        os << "#include <sys/mman.h>" << std::endl;
+        os << "#include <sys/stat.h>" << std::endl;
+        os << "#include <unistd.h>" << std::endl;
+    }
+
+    if (HasBitsAttrs()) {
+        os << "#include <type_traits>" << std::endl;
+    }
+
+    if (HasInternedAttrs() || UsesLocation()) {
+        os << "#include <cstdint>" << std::endl;
+        os << "#include <map>" << std::endl;
+        os << "#include <mutex>" << std::endl;
+        os << "#include <stdexcept>" << std::endl;
+        os << "#include <string>" << std::endl;
+    }
+
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitIntern() -- Emit the intern tables and the location type
+//
+// An interned attribute holds the index of its value in the intern table for its type, which keeps one copy of each
+// distinct value.  The values are never moved once they are added, and the index of a value is only handed out once
+// it is in place, so the lookup by index does not need the lock.  Each thread also keeps the values it has added in
+// a map of its own, so building nodes with values already seen by the thread takes no lock at all.  The location
+// type packs the index of the file name (in its own table) and the line number into 32 bits: 12 bits for the file
+// and 20 for the line.  A table that runs out of indexes throws std::length_error rather than wrap or saturate.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitIntern(std::ofstream &os)
+{
+    if (!HasInternedAttrs() && !UsesLocation()) return;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// The intern tables hold one copy of each distinct value of the interned attributes" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class T, int P = 0>" << std::endl;
+    os << "struct ASTIntern {" << std::endl;
+    os << "\tstatic unsigned int Add(const T &v) {" << std::endl;
+    os << "\t\tstatic thread_local std::map<T, unsigned int> seen;" << std::endl;
+    os << "\t\ttypename std::map<T, unsigned int>::iterator s = seen.find(v);" << std::endl << std::endl;
+    os << "\t\tif (s != seen.end()) return s->second;" << std::endl << std::endl;
+    os << "\t\tunsigned int i = AddShared(v);" << std::endl;
+    os << "\t\tseen.insert(std::make_pair(v, i));" << std::endl;
+    os << "\t\treturn i;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstatic const T &Get(unsigned int i) { return *Tab().chunks[i >> 12][i & 0xfff]; }" << std::endl;
+    os << "\tstatic unsigned int Count(void) { std::lock_guard<std::mutex> lock(Tab().mutex); return Tab().count; }"
+            << std::endl << std::endl;
+
+    os << "private:" << std::endl;
+    os << "\tenum { CHUNKS = 16384, CHUNK = 4096 };" << std::endl << std::endl;
+
+    os << "\tstatic unsigned int AddShared(const T &v) {" << std::endl;
+    os << "\t\tTable &t = Tab();" << std::endl;
+    os << "\t\tstd::lock_guard<std::mutex> lock(t.mutex);" << std::endl;
+    os << "\t\ttypename std::map<T, unsigned int>::iterator it = t.index.find(v);" << std::endl << std::endl;
+    os << "\t\tif (it != t.index.end()) return it->second;" << std::endl;
+    os << "\t\tif (t.count >= (unsigned int)CHUNKS * CHUNK) throw std::length_error(\"ASTIntern: the table is full\");"
+            << std::endl << std::endl;
+    os << "\t\tunsigned int i = t.count ++;" << std::endl;
+    os << "\t\tif (!t.chunks[i >> 12]) t.chunks[i >> 12] = new const T *[CHUNK];" << std::endl;
+    os << "\t\tt.chunks[i >> 12][i & 0xfff] = &t.index.insert(std::make_pair(v, i)).first->first;" << std::endl;
+    os << "\t\treturn i;" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+
+    os << "\tstruct Table {" << std::endl;
+    os << "\t\tstd::mutex mutex;" << std::endl;
+    os << "\t\tstd::map<T, unsigned int> index;" << std::endl;
+    os << "\t\tconst T **chunks[CHUNKS];" << std::endl;
+    os << "\t\tunsigned int count;" << std::endl;
+    os << "\t};" << std::endl << std::endl;
+
+    os << "\tstatic Table &Tab(void) { static Table t; return t; }" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "struct ASTLocation {" << std::endl;
+    os << "\tuint32_t bits;" << std::endl << std::endl;
+    os << "\tASTLocation(void) : bits(0xfff00000u) { }" << std::endl;
+    os << "\tASTLocation(const std::string &file, unsigned int line) {" << std::endl;
+    os << "\t\tunsigned int f = ASTIntern<std::string, 1>::Add(file);" << std::endl;
+    os << "\t\tif (f >= 0xfff) throw std::length_error(\"ASTLocation: more than 4095 file names\");" << std::endl;
+    os << "\t\tbits = (f << 20) | (line < 0xfffff ? line : 0xfffff);" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+    os << "\tunsigned int Line(void) const { return bits & 0xfffff; }" << std::endl;
+    os << "\tconst std::string &File(void) const {" << std::endl;
+    os << "\t\tstatic const std::string unknown;" << std::endl;
+    os << "\t\treturn (bits >> 20) == 0xfff ? unknown : ASTIntern<std::string, 1>::Get(bits >> 20);" << std::endl;
+    os << "\t}" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "typedef ASTLocation location;" << std::endl;
+    os << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitBits() -- Emit ASTBits, which takes a bits(N) attribute out of its packed word as its own type
+//
+// The field is N bits wide, so a signed type has its sign bit at N-1 and is sign-extended; the compiler knows the
+// types named in the source (which may be typedefs), so std::is_signed picks the case.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitBits(std::ofstream &os)
+{
+    if (!HasBitsAttrs()) return;
+
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "// ASTBits -- the value of a bits(N) field, sign-extended for a signed type" << std::endl;
+    os << "//-----------------------------------------------------------------------------------------------" << std::endl;
+    os << "template <class T, bool S = std::is_signed<T>::value>" << std::endl;
+    os << "struct ASTBits {" << std::endl;
+    os << "\ttemplate <int N, class W> static T Get(W v) { return (T)v; }" << std::endl;
+    os << "};" << std::endl << std::endl;
+
+    os << "template <class T>" << std::endl;
+    os << "struct ASTBits<T, true> {" << std::endl;
+    os << "\ttemplate <int N, class W> static T Get(W v) {" << std::endl;
+    os << "\t\tif (N >= 64) return (T)v;" << std::endl;
+    os << "\t\treturn (T)((long long)(v ^ ((W)1 << (N - 1))) - (long long)((W)1 << (N - 1)));" << std::endl;
+    os << "\t}" << std::endl;
+    os << "};" << std::endl;
     os << std::endl << std::endl;
 }
 
@@ -132,6 +381,69 @@ static void cpp_EmitNodeTypes(std::ofstream &os)
 }
 
 
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_BitsWord() -- Get the name of the word that holds the packed bits(N) attributes of a node
+//-------------------------------------------------------------------------------------------------------------------
+std::string cpp_BitsWord(Node *node)
+{
+    return "_" + node->Get_Name()->Get_Name() + "_bits";
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_BitsType() -- Get the type of the word that holds the packed bits(N) attributes of a node
+//-------------------------------------------------------------------------------------------------------------------
+static std::string cpp_BitsType(Node *node)
+{
+    return (node->GetBitsWidth() > 32 ? "unsigned long long" : "unsigned int");
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_BitsMask() -- Get the mask of a bits(N) attribute, before it is shifted into place
+//-------------------------------------------------------------------------------------------------------------------
+std::string cpp_BitsMask(Node *node, Attribute *a)
+{
+    char buf[32];
+
+    snprintf(buf, sizeof(buf), "0x%llx%s", (a->Get_Bits() >= 64 ? ~0ull : (1ull << a->Get_Bits()) - 1),
+            (node->GetBitsWidth() > 32 ? "ull" : "u"));
+    return std::string(buf);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_BitsValue() -- Get the value of a bits(N) attribute out of the packed word of the object at obj ("" for this)
+//-------------------------------------------------------------------------------------------------------------------
+std::string cpp_BitsValue(Node *node, Attribute *a, const std::string &obj)
+{
+    std::ostringstream rv;
+
+    rv << "ASTBits<" << a->Get_Type()->Get_Name() << ">::Get<" << a->Get_Bits() << ">((" << obj << cpp_BitsWord(node)
+            << " >> " << node->GetBitsShift(a) << ") & " << cpp_BitsMask(node, a) << ")";
+    return rv.str();
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitBitsPack() -- Emit a value of a bits(N) attribute masked and shifted into its place in the word
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitBitsPack(std::ofstream &os, Node *node, Attribute *a, const std::string &val)
+{
+    os << "(((" << cpp_BitsType(node) << ")(" << val << ") & " << cpp_BitsMask(node, a) << ") << "
+            << node->GetBitsShift(a) << ")";
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_LazyWord() -- Get the name of the word that tracks which lazy attributes of a node have been evaluated
+//-------------------------------------------------------------------------------------------------------------------
+static std::string cpp_LazyWord(Node *node)
+{
+    return "_" + node->Get_Name()->Get_Name() + "_lazy";
+}
+
+
 //-------------------------------------------------------------------------------------------------------------------
 // cpp_EmitConstructorParms() -- Emit the class Constructor parameter list -- returns whether a parm was printed
 //-------------------------------------------------------------------------------------------------------------------
@@ -145,7 +457,7 @@ static bool cpp_EmitConstructorParms(std::ofstream &os, Node *node)
     for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
         Attribute *a = al->elem();
 
-        if (a->Get_Flags() & NOINIT) continue;
+        if (a->Get_Flags() & (NOINIT | COMPUTED | LAZY)) continue;
         if (parmPrinted) os << "," << std::endl << "\t\t";
         os << a->Get_Type()->Get_Name() << (a->Get_Type()->Get_Kind()==NODE?" *":" ")
                 << "__init__" << a->Get_Name();
@@ -169,7 +481,7 @@ static bool cpp_EmitConstructorArgs(std::ofstream &os, Node *node)
     for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
         Attribute *a = al->elem();
 
-        if (a->Get_Flags() & NOINIT) continue;
+        if (a->Get_Flags() & (NOINIT | COMPUTED | LAZY)) continue;
         if (parmPrinted) os << "," << std::endl << "\t\t";
         os << "__init__" << a->Get_Name();
         parmPrinted = true;
@@ -192,7 +504,7 @@ static bool cpp_EmitConstructorBase(std::ofstream &os, Node *node)
     for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
         Attribute *a = al->elem();
 
-        if (a->Get_Flags() & NOINIT) continue;
+        if (a->Get_Flags() & (NOINIT | COMPUTED | LAZY)) continue;
         if (parmPrinted) os << "," << std::endl << "\t\t";
         os << "__init__" << a->Get_Name();
         parmPrinted = true;
@@ -250,19 +562,265 @@ static void cpp_EmitConstructor(std::ofstream &os, Node *node)
     for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
         Attribute *a = al->elem();
 
+        //
+        // -- the bits(N) attributes are all packed into the word where the first one is
+        //    --------------------------------------------------------------------------
+        if (a->Get_Bits()) {
+            if (node->GetBitsShift(a) != 0) continue;
+            if (needComma) os << "," << std::endl << "\t\t";
+            os << cpp_BitsWord(node) << "(";
+
+            for (AttrList *bl = al; More(bl); bl = Next(bl)) {
+                Attribute *b = bl->elem();
+
+                if (!b->Get_Bits()) continue;
+                if (b != a) os << " | ";
+                cpp_EmitBitsPack(os, node, b, (b->Get_Flags() & NOINIT) ? b->Get_Code() : "__init__" + b->Get_Name());
+            }
+
+            os << ")";
+            needComma = true;
+            continue;
+        }
+
         if (needComma) os << "," << std::endl << "\t\t";
         os << a->Get_Name() << "(";
+        if (a->Get_Flags() & INTERNED) os << "ASTIntern<" << a->Get_Type()->Get_Name() << ">::Add(";
         if (a->Get_Flags() & NOINIT) {
             os << a->Get_Code();
+        } else if (a->Get_Flags() & (COMPUTED | LAZY)) {
+            // -- value-initialized; it is not evaluated until the first call to Get_
         } else {
             os << "__init__" << a->Get_Name();
         }
+        if (a->Get_Flags() & INTERNED) os << ")";
+        os << ")";
+        needComma = true;
+    }
+
+exit:
+    //
+    // -- the most derived constructor runs last, so it is the one that leaves the tag set properly
+    //    -----------------------------------------------------------------------------------------
+    if (node->Get_Flags() & ABSTRACT) os << " { }" << std::endl;
+    else if (NeedParentLinks()) os << " { _tag = NODE_TYPE_" << node->Get_Name()->Get_Name() << "; _AdoptChildren(); }" << std::endl;
+    else os << " { _tag = NODE_TYPE_" << node->Get_Name()->Get_Name() << "; }" << std::endl;
+    os << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitLiteralParms() -- Emit the literal constructor parameters, one for every attribute that is stored
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitLiteralParms(std::ofstream &os, Node *node)
+{
+    if (!node) return;
+
+    cpp_EmitLiteralParms(os, node->Get_Parent());
+
+    for (AttrList *al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        Attribute *a = al->elem();
+
+        if (a->Get_Flags() & STATIC) continue;
+        os << "," << std::endl << "\t\t" << a->Get_Type()->Get_Name() << (a->Get_Type()->Get_Kind()==NODE?" *":" ")
+                << "__init__" << a->Get_Name();
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitLiteralArgs() -- Emit the literal constructor arguments passed on to the base class
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitLiteralArgs(std::ofstream &os, Node *node)
+{
+    if (!node) return;
+
+    cpp_EmitLiteralArgs(os, node->Get_Parent());
+
+    for (AttrList *al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        if (al->elem()->Get_Flags() & STATIC) continue;
+        os << ", __init__" << al->elem()->Get_Name();
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitLiteralInit() -- Emit the literal constructor, which is public for a literal node and protected (taking
+//                          the node type tag from the derived class) for a base class of a literal node
+//
+// The constructor is constexpr, so a literal tree is built at compile time: every attribute that is stored is a
+// parameter (including the no-init attributes, whose code may not be a constant expression), and the ASTLiteral
+// parameter only tells it apart from the regular constructor.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitLiteralInit(std::ofstream &os, Node *node, bool base)
+{
+    std::string name = node->Get_Name()->Get_Name();
+
+    os << (base ? "protected:" : "public:") << std::endl;
+    os << "\tconstexpr " << name << "(ASTLiteral" << (node->Get_Parent() ? " l" : "") << (base ? ", ASTNodeType t" : "");
+    cpp_EmitLiteralParms(os, node);
+    os << ") :" << std::endl << "\t\t";
+
+    //
+    // -- the root node sets the tag; the others pass it on to their base class
+    //    ---------------------------------------------------------------------
+    std::string tag = (base ? "t" : "NODE_TYPE_" + name);
+
+    if (node->Get_Parent()) {
+        os << node->Get_Parent()->Get_Name()->Get_Name() << "(l, " << tag;
+        cpp_EmitLiteralArgs(os, node->Get_Parent());
+        os << ")";
+    } else os << "_tag(" << tag << ")";
+
+    for (AttrList *al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        Attribute *a = al->elem();
+
+        if (a->Get_Flags() & STATIC) continue;
+        if (a->Get_Bits() && node->GetBitsShift(a) != 0) continue;
+        os << "," << std::endl << "\t\t";
+
+        if (!a->Get_Bits()) {
+            os << a->Get_Name() << "(__init__" << a->Get_Name() << ")";
+            continue;
+        }
+
+        os << cpp_BitsWord(node) << "(";
+
+        for (AttrList *bl = al; More(bl); bl = Next(bl)) {
+            Attribute *b = bl->elem();
+
+            if (!b->Get_Bits()) continue;
+            if (b != a) os << " | ";
+            cpp_EmitBitsPack(os, node, b, "__init__" + b->Get_Name());
+        }
+
         os << ")";
+    }
+
+    os << " { }" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitLiteralConstructor() -- Emit the literal constructors of a node, if it is a literal node or a base class
+//                                 of one
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitLiteralConstructor(std::ofstream &os, Node *node)
+{
+    bool literal = ((node->Get_Flags() & LITERAL) != 0);
+    bool base = IsLiteralBase(node);
+
+    if (!literal && !base) return;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The " << node->Get_Name()->Get_Name() << " literal constructor" << std::endl;
+    os << "\t//----------------------------------------------------------------------------------" << std::endl;
+
+    if (literal) cpp_EmitLiteralInit(os, node, false);
+    if (base) cpp_EmitLiteralInit(os, node, true);
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_AttrIndex() -- Get the index of an attribute among all the attributes of a node, starting with those inherited
+//-------------------------------------------------------------------------------------------------------------------
+static int cpp_AttrIndex(Node *node, Attribute *a)
+{
+    int rv = 0;
+    Node *n;
+    AttrList *al;
+
+    for (n = node->Get_Parent(); n; n = n->Get_Parent()) rv += Len(n->Get_Attrs());
+
+    for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        if (al->elem() == a) return rv;
+        rv ++;
+    }
+
+    return -1;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitCopyConstructor() -- Emit the constructor that copies a node, replacing one attribute
+//
+// This constructor is how the with_ functions build their new node.  The attribute to replace is named by its
+// index from cpp_AttrIndex() and its new value is passed by address; all the others are copied from the original,
+// each class copying its own (possibly private) attributes.  Since immutable nodes may derive from nodes that are
+// not, all the nodes get this constructor when there are any immutable nodes.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitCopyConstructor(std::ofstream &os, Node *node)
+{
+    if (!HasImmutableNodes()) return;
+
+    std::string name = node->Get_Name()->Get_Name();
+    bool needComma = false;
+    bool used = (node->Get_Parent() != NULL);
+    AttrList *al;
+
+    for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        if (!(al->elem()->Get_Flags() & (STATIC | COMPUTED | LAZY))) used = true;
+    }
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The " << name << " copy constructor, which replaces one attribute" << std::endl;
+    os << "\t//----------------------------------------------------------------------------------" << std::endl;
+
+    os << "protected:" << std::endl;
+    if (used) os << "\t" << name << "(const " << name << " &o, int w, const void *v)";
+    else os << "\t" << name << "(const " << name << " &, int, const void *)";
+
+    if (node->GetAttrCount() == 0 && !node->Get_Parent()) goto exit;
+
+    os << " :" << std::endl << "\t\t";
+    if (node->Get_Parent()) {
+        os << node->Get_Parent()->Get_Name()->Get_Name() << "(o, w, v)";
+        needComma = true;
+    }
+
+    for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        Attribute *a = al->elem();
+
+        if (a->Get_Flags() & STATIC) continue;
+        if (a->Get_Bits() && node->GetBitsShift(a) != 0) continue;
+        if (needComma) os << "," << std::endl << "\t\t";
+
+        if (a->Get_Bits()) {
+            std::string word = cpp_BitsWord(node);
+
+            os << word << "(";
+
+            for (AttrList *bl = al; More(bl); bl = Next(bl)) {
+                Attribute *b = bl->elem();
+
+                if (!b->Get_Bits()) continue;
+                os << "w == " << cpp_AttrIndex(node, b) << " ? (o." << word << " & ~(" << cpp_BitsMask(node, b) << " << "
+                        << node->GetBitsShift(b) << ")) | ";
+                cpp_EmitBitsPack(os, node, b, "*static_cast<const " + b->Get_Type()->Get_Name() + " *>(v)");
+                os << " :" << std::endl << "\t\t\t";
+            }
+
+            os << "o." << word << ")";
+        } else if (a->Get_Flags() & (COMPUTED | LAZY)) {
+            os << a->Get_Name() << "()";
+        } else if (a->Get_Flags() & INTERNED) {
+            os << a->Get_Name() << "(w == " << cpp_AttrIndex(node, a) << " ? ASTIntern<" << a->Get_Type()->Get_Name()
+                    << ">::Add(*static_cast<const " << a->Get_Type()->Get_Name() << " *>(v)) : o." << a->Get_Name()
+                    << ")";
+        } else if (a->Get_Type()->Get_Kind() == NODE) {
+            os << a->Get_Name() << "(w == " << cpp_AttrIndex(node, a) << " ? *static_cast<"
+                    << a->Get_Type()->Get_Name() << " *const *>(v) : o." << a->Get_Name() << ")";
+        } else {
+            os << a->Get_Name() << "(w == " << cpp_AttrIndex(node, a) << " ? *static_cast<const "
+                    << a->Get_Type()->Get_Name() << " *>(v) : o." << a->Get_Name() << ")";
+        }
+
         needComma = true;
     }
 
 exit:
-    os << " { }" << std::endl;
+    if (node->Get_Flags() & ABSTRACT) os << " { }" << std::endl;
+    else os << " { _tag = NODE_TYPE_" << name << "; }" << std::endl;
     os << std::endl;
 }
 
@@ -277,18 +835,183 @@ static void cpp_EmitDestructor(std::ofstream &os, Node *node)
     os << "\t//--------------------------------------------------------------------------------" << std::endl;
 
     os << "public:" << std::endl;
-    os << "\tvirtual ~" << node->Get_Name()->Get_Name() << "(void) { }" << std::endl << std::endl;
+    os << "\tvirtual ~" << node->Get_Name()->Get_Name() << "(void) {";
+
+    //
+    // -- the most derived destructor runs first, while all of the owned children are still in place
+    //    ------------------------------------------------------------------------------------------
+    if (!(node->Get_Flags() & ABSTRACT) && node->GetOwnedCount()) {
+        os << " _DestroyOwned(NODE_TYPE_" << node->Get_Name()->Get_Name() << ");";
+    }
+
+    //
+    // -- the tag still names the most derived type when the root destructor runs
+    //    -----------------------------------------------------------------------
+    if ((options & OPT_STATS) && !node->Get_Parent()) os << " AST_STATS_DESTROYED(_tag);";
+
+    os << " }" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitTag() -- Emit the stored node type tag; only the root node carries it
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitTag(std::ofstream &os, Node *node)
+{
+    if (node->Get_Parent()) return;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The node type tag, which is read without a virtual call" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+
+    os << "protected:" << std::endl;
+    os << "\tASTNodeType _tag;" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tASTNodeType _GetTag(void) const { return _tag; }" << std::endl << std::endl;
+
+    //
+    // -- these are defined with the child slot tables
+    //    --------------------------------------------
+    os << "\t//" << std::endl;
+    os << "\t// -- Uniform access to the children, by child slot index" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+    os << "public:" << std::endl;
+    os << "\tinline int _ChildCount(void) const;" << std::endl;
+    os << "\tinline " << node->Get_Name()->Get_Name() << " *_Child(int i) const;" << std::endl;
+
+    //
+    // -- an immutable node must never have a child replaced in place, so with immutable nodes only the
+    //    _WithChild() copy is offered
+    //    ---------------------------------------------------------------------------------------------
+    if (HasImmutableNodes()) {
+        os << "\tinline " << node->Get_Name()->Get_Name() << " *_WithChild(int i, " << node->Get_Name()->Get_Name()
+                << " *n);" << std::endl;
+    } else {
+        os << "\tinline " << node->Get_Name()->Get_Name() << " *_ReplaceChild(int i, " << node->Get_Name()->Get_Name()
+                << " *n);" << std::endl;
+    }
+
+    os << std::endl;
+
+    if (HasOwnedAttrs()) {
+        os << "protected:" << std::endl;
+        os << "\tinline void _DestroyOwned(ASTNodeType type);" << std::endl << std::endl;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitParentLink() -- Emit the link to the parent node and the bits that track which computed attributes are
+//                         cached; only the root node carries them.  The members that need the complete node types
+//                         are defined with the child slot tables.
+//
+// _Invalidate() clears the cached bits of a node and of every node above it, so without a way to stop early a
+// bulk update of a deep tree costs the depth of the tree for each node.  Each node records the cache epoch in
+// which it was last cleared, and the epoch moves on whenever a node with nothing cached caches something.  So a
+// node cleared in the current epoch has nothing cached above it, and the walk stops there.  A node gets a new
+// parent only when the parent is then invalidated (or is new), which keeps that true across the moves.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitParentLink(std::ofstream &os, Node *node)
+{
+    if (node->Get_Parent()) return;
+    if (!NeedParentLinks()) return;
+
+    std::string root = node->Get_Name()->Get_Name();
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The link to the parent node and the cached computed attributes" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+
+    os << "protected:" << std::endl;
+    os << "\t" << root << " *_parent = NULL;" << std::endl;
+    os << "\tint _slot = -1;" << std::endl;
+    os << "\tunsigned int _valid = 0;" << std::endl;
+    os << "\tunsigned long _cleared = 0;" << std::endl << std::endl;
+
+    os << "\tstatic unsigned long &_Epoch(void) { static unsigned long e = 1; return e; }" << std::endl;
+    os << "\tvoid _Cache(unsigned int bit) { if (!_valid) _Epoch() ++; _valid |= bit; }" << std::endl << std::endl;
+
+    os << "\tinline void _AdoptChildren(void);" << std::endl;
+    os << "\tinline void _AdoptSlot(int i);" << std::endl;
+    os << "\tinline void _ReleaseSlot(int i);" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\t" << root << " *_GetParent(void) const { return _parent; }" << std::endl;
+    os << "\tint _GetSlotIndex(void) const { return _slot; }" << std::endl;
+    os << "\tvoid _Invalidate(void) {" << std::endl;
+    os << "\t\tunsigned long e = _Epoch();" << std::endl << std::endl;
+    os << "\t\tfor (" << root << " *n = this; n && n->_cleared != e; n = n->_parent) {" << std::endl;
+    os << "\t\t\tn->_valid = 0;" << std::endl;
+    os << "\t\t\tn->_cleared = e;" << std::endl;
+    os << "\t\t}" << std::endl;
+    os << "\t}" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitId() -- Emit the node id (--ids only); only the root node carries it.  It is numbered by its default member
+//                 initializer, so every constructor numbers the node, including the copy constructor of the with_
+//                 functions.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitId(std::ofstream &os, Node *node)
+{
+    if (node->Get_Parent()) return;
+    if (!(options & OPT_IDS)) return;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The node id, which indexes the side tables" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+
+    os << "protected:" << std::endl;
+    os << "\tunsigned int _id = ASTIds::Next();" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tunsigned int _GetId(void) const { return _id; }" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitDigestMember() -- Emit the cached digest (--digest only); only the root node carries it.  Whether it is
+//                           up to date is the top bit of the word that tracks the cached computed attributes, so
+//                           the setters invalidate it on the path to the root along with them.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitDigestMember(std::ofstream &os, Node *node)
+{
+    if (node->Get_Parent()) return;
+    if (!(options & OPT_DIGEST)) return;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The digest of the subtree, which is computed when it is asked for" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+
+    os << "protected:" << std::endl;
+    os << "\tASTDigest _digest;" << std::endl << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\ttemplate <class H = ASTDigester> inline const ASTDigest &_GetDigest(void);" << std::endl << std::endl;
 }
 
 
 //-------------------------------------------------------------------------------------------------------------------
 // cpp_EmitAttributes() -- Emit the class Attributes
+//
+// A computed attribute has no setter; its getter evaluates the code the first time and caches the value until
+// the node or anything below it changes.  So, when parent links are maintained, the setters for the other
+// attributes invalidate the cached values on the path to the root (and the child setters keep the links).
+//
+// A lazy attribute is also evaluated by its getter the first time, but it is never evaluated again.  A bit in a
+// word of the node records that it has been; its setter stores a value and sets the bit, so the code never runs.
+// An immutable node can be shared by several threads, so it evaluates each lazy attribute under a once-flag
+// instead, and the attribute has no setter.
+//
+// The other attributes that an immutable node defines are const and have no setter.
 //-------------------------------------------------------------------------------------------------------------------
-static void cpp_EmitAttributes(std::ofstream &os, AttrList *attrs)
+static void cpp_EmitAttributes(std::ofstream &os, Node *node)
 {
     AttrList *al;
 
-    for (al = First(attrs); More(al); al = Next(al)) {
+    for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
         Attribute *a = al->elem();
 
         //
@@ -298,12 +1021,39 @@ static void cpp_EmitAttributes(std::ofstream &os, AttrList *attrs)
         os << "\t// -- The " << a->Get_Name() << " attribute" << std::endl;
         os << "\t//---------------------------------------------------------------------------------" << std::endl;
 
-        if (a->Get_Flags() & PUBLIC) os << "public:" << std::endl;
+        if (a->Get_Bits()) {
+            if (node->GetBitsShift(a) == 0) {
+                os << "protected:" << std::endl;
+                os << "\t" << ((node->Get_Flags() & IMMUTABLE)?"const ":"") << cpp_BitsType(node) << " "
+                        << cpp_BitsWord(node) << ";" << std::endl << std::endl;
+            }
+        } else if (a->Get_Flags() & PUBLIC) os << "public:" << std::endl;
         else if (a->Get_Flags() & PROTECTED) os << "protected:" << std::endl;
         else os << "private:" << std::endl;
 
-        os << "\t" << (a->Get_Flags()&STATIC?"static ":"") << a->Get_Type()->Get_Name() << " "
-                << (a->Get_Type()->Get_Kind()==NODE?"*":"") << a->Get_Name() << ";" << std::endl << std::endl;
+        if (a->Get_Bits()) {
+            // -- the packed word was emitted with the first of them
+        } else if (a->Get_Flags() & LAZY) {
+            os << "\t" << a->Get_Type()->Get_Name() << " " << (a->Get_Type()->Get_Kind()==NODE?"*":"") << a->Get_Name()
+                    << ";" << std::endl;
+
+            if (node->Get_Flags() & IMMUTABLE) {
+                os << "\tstd::once_flag _" << a->Get_Name() << "_once;" << std::endl;
+            } else if (node->GetLazyIndex(a) == 0) {
+                os << "\tunsigned int " << cpp_LazyWord(node) << " = 0;" << std::endl;
+            }
+
+            os << std::endl;
+        } else if (a->Get_Flags() & INTERNED) {
+            os << "\t" << ((node->Get_Flags() & IMMUTABLE)?"const ":"") << "unsigned int " << a->Get_Name() << ";"
+                    << std::endl << std::endl;
+        } else if ((node->Get_Flags() & IMMUTABLE) && !(a->Get_Flags() & STATIC)) {
+            os << "\t" << (a->Get_Type()->Get_Kind()==NODE?"":"const ") << a->Get_Type()->Get_Name() << " "
+                    << (a->Get_Type()->Get_Kind()==NODE?"*const ":"") << a->Get_Name() << ";" << std::endl << std::endl;
+        } else {
+            os << "\t" << (a->Get_Flags()&STATIC?"static ":"") << a->Get_Type()->Get_Name() << " "
+                    << (a->Get_Type()->Get_Kind()==NODE?"*":"") << a->Get_Name() << ";" << std::endl << std::endl;
+        }
 
         //
         // -- if not disabled, emit the access methods
@@ -311,23 +1061,149 @@ static void cpp_EmitAttributes(std::ofstream &os, AttrList *attrs)
         if (a->Get_Flags() & NOINLINES) continue;
 
         os << "public:" << std::endl;
-        os << "\t" << a->Get_Type()->Get_Name() << " " << (a->Get_Type()->Get_Kind()==NODE?"*":"")
-                << "Get_" << a->Get_Name() << "(void) { return " << a->Get_Name() << "; }" << std::endl;
+
+        if (a->Get_Flags() & COMPUTED) {
+            unsigned int bit = 1u << node->GetComputedIndex(a);
+
+            os << "\t" << a->Get_Type()->Get_Name() << " " << (a->Get_Type()->Get_Kind()==NODE?"*":"")
+                    << "Get_" << a->Get_Name() << "(void) {" << std::endl;
+            os << "\t\tif (!(_valid & " << bit << "u)) { " << a->Get_Name() << " = (" << a->Get_Code()
+                    << "); _Cache(" << bit << "u); }" << std::endl;
+            os << "\t\treturn " << a->Get_Name() << ";" << std::endl;
+            os << "\t}" << std::endl << std::endl;
+            continue;
+        }
+
+        if (a->Get_Flags() & LAZY) {
+            std::string type = a->Get_Type()->Get_Name() + (a->Get_Type()->Get_Kind()==NODE?" *":" ");
+
+            os << "\t" << type << "Get_" << a->Get_Name() << "(void) {" << std::endl;
+
+            if (node->Get_Flags() & IMMUTABLE) {
+                os << "\t\tstd::call_once(_" << a->Get_Name() << "_once, [this] { " << a->Get_Name() << " = ("
+                        << a->Get_Code() << "); });" << std::endl;
+                os << "\t\treturn " << a->Get_Name() << ";" << std::endl;
+                os << "\t}" << std::endl << std::endl;
+                continue;
+            }
+
+            unsigned int bit = 1u << node->GetLazyIndex(a);
+
+            os << "\t\tif (!(" << cpp_LazyWord(node) << " & " << bit << "u)) { " << a->Get_Name() << " = ("
+                    << a->Get_Code() << "); " << cpp_LazyWord(node) << " |= " << bit << "u; }" << std::endl;
+            os << "\t\treturn " << a->Get_Name() << ";" << std::endl;
+            os << "\t}" << std::endl << std::endl;
+
+            os << "\tvoid Set_" << a->Get_Name() << "(" << type << "val) { " << a->Get_Name() << " = val; "
+                    << cpp_LazyWord(node) << " |= " << bit << "u;" << (NeedParentLinks()?" _Invalidate();":"") << " }"
+                    << std::endl << std::endl;
+            continue;
+        }
+
+        if (a->Get_Bits()) {
+            os << "\t" << a->Get_Type()->Get_Name() << " Get_" << a->Get_Name() << "(void) { return "
+                    << cpp_BitsValue(node, a, "") << "; }" << std::endl;
+        } else if (a->Get_Flags() & INTERNED) {
+            os << "\tconst " << a->Get_Type()->Get_Name() << " &Get_" << a->Get_Name() << "(void) { return ASTIntern<"
+                    << a->Get_Type()->Get_Name() << ">::Get(" << a->Get_Name() << "); }" << std::endl;
+        } else {
+            os << "\t" << a->Get_Type()->Get_Name() << " " << (a->Get_Type()->Get_Kind()==NODE?"*":"")
+                    << "Get_" << a->Get_Name() << "(void) { return " << a->Get_Name() << "; }" << std::endl;
+        }
+
+        if ((node->Get_Flags() & IMMUTABLE) && !(a->Get_Flags() & STATIC)) {
+            os << std::endl;
+            continue;
+        }
+
         os << "\tvoid Set_"<< a->Get_Name() << "(" << a->Get_Type()->Get_Name() << " "
-                << (a->Get_Type()->Get_Kind()==NODE?"*":"") << "val) { "
-                << a->Get_Name() << " = val; }" << std::endl << std::endl;
+                << (a->Get_Type()->Get_Kind()==NODE?"*":"") << "val) { ";
+
+        if (a->Get_Bits()) {
+            os << cpp_BitsWord(node) << " = (" << cpp_BitsWord(node) << " & ~(" << cpp_BitsMask(node, a) << " << "
+                    << node->GetBitsShift(a) << ")) | ";
+            cpp_EmitBitsPack(os, node, a, "val");
+            os << ";" << (NeedParentLinks()?" _Invalidate();":"") << " }" << std::endl << std::endl;
+        } else if (a->Get_Flags() & INTERNED) {
+            os << a->Get_Name() << " = ASTIntern<" << a->Get_Type()->Get_Name() << ">::Add(val);"
+                    << (NeedParentLinks()?" _Invalidate();":"") << " }" << std::endl << std::endl;
+        } else if (!NeedParentLinks() || (a->Get_Flags() & STATIC)) {
+            os << a->Get_Name() << " = val; }" << std::endl << std::endl;
+        } else if (a->Is_Child()) {
+            int i = node->GetChildIndex(a);
+
+            os << "_ReleaseSlot(" << i << "); " << a->Get_Name() << " = val; _AdoptSlot(" << i << "); }"
+                    << std::endl << std::endl;
+        } else {
+            os << a->Get_Name() << " = val; _Invalidate(); }" << std::endl << std::endl;
+        }
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitWithFuncs() -- Emit the with_ functions for the attributes of an immutable node, starting with those
+//                        inherited.  Each builds a new node that shares all the other attributes.
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitWithFuncs(std::ofstream &os, Node *node, Node *concrete)
+{
+    if (!node) return;
+
+    cpp_EmitWithFuncs(os, node->Get_Parent(), concrete);
+
+    std::string name = concrete->Get_Name()->Get_Name();
+    AttrList *al;
+
+    for (al = First(node->Get_Attrs()); More(al); al = Next(al)) {
+        Attribute *a = al->elem();
+
+        if (a->Get_Flags() & (STATIC | COMPUTED | LAZY)) continue;
+
+        os << "\t" << name << " *with_" << a->Get_Name() << "(" << a->Get_Type()->Get_Name() << " "
+                << (a->Get_Type()->Get_Kind()==NODE?"*":"") << "val) const {";
+
+        if (options & (OPT_STATS | OPT_INDEX)) {
+            os << std::endl;
+            os << "\t\t" << name << " *rv = new " << name << "(*this, " << cpp_AttrIndex(node, a) << ", &val);"
+                    << std::endl;
+            if (options & OPT_STATS) os << "\t\tAST_STATS_CREATED(NODE_TYPE_" << name << ");" << std::endl;
+            if (options & OPT_INDEX) os << "\t\tASTIndex::Register(rv, NODE_TYPE_" << name << ");" << std::endl;
+            os << "\t\treturn rv;" << std::endl;
+            os << "\t}" << std::endl;
+        } else {
+            os << " return new " << name << "(*this, " << cpp_AttrIndex(node, a) << ", &val); }" << std::endl;
+        }
     }
 }
 
 
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitWith() -- Emit the with_ functions of a concrete immutable node
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitWith(std::ofstream &os, Node *node)
+{
+    if (!(node->Get_Flags() & IMMUTABLE)) return;
+    if (node->Get_Flags() & ABSTRACT) return;
+    if (node->GetAttrCount() == 0) return;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The " << node->Get_Name()->Get_Name() << " with_ functions" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+
+    os << "public:" << std::endl;
+    cpp_EmitWithFuncs(os, node, node);
+    os << std::endl;
+}
+
+
 //-------------------------------------------------------------------------------------------------------------------
 // cpp_EmitMethods() -- Emit the class Methods
 //-------------------------------------------------------------------------------------------------------------------
-static void cpp_EmitMethods(std::ofstream &os, MethList *meths)
+static void cpp_EmitMethods(std::ofstream &os, Node *node)
 {
     MethList *ml;
 
-    for (ml = First(meths); More(ml); ml = Next(ml)) {
+    for (ml = First(node->Get_Meths()); More(ml); ml = Next(ml)) {
         Method *m = ml->elem();
 
         //
@@ -341,7 +1217,14 @@ static void cpp_EmitMethods(std::ofstream &os, MethList *meths)
         else if (m->Get_Flags() & PROTECTED) os << "protected:" << std::endl;
         else os << "public:" << std::endl;
 
-        os << (m->Get_Flags()&STATIC?"\tstatic ":"\tvirtual ") << m->Get_Type()->Get_Name() << " "
+        //
+        // -- with --final, a method that neither overrides nor is overridden is not virtual
+        //    ------------------------------------------------------------------------------
+        if (m->Get_Flags() & STATIC) os << "\tstatic ";
+        else if (m->Get_Flags() & NONVIRTUAL) os << "\t";
+        else os << "\tvirtual ";
+
+        os << m->Get_Type()->Get_Name() << " "
                 << (m->Get_Type()->Get_Kind()==NODE?"*":"") << m->Get_Name() << "(";
         if (Len(m->Get_Parms()) == 0) os << "void";
         else {
@@ -358,10 +1241,14 @@ static void cpp_EmitMethods(std::ofstream &os, MethList *meths)
             }
         }
         os << ")";
+        if (m->Get_Flags() & FINAL) os << " final";
 
         if (m->Get_Flags() & ABSTRACT) os << " = 0;" << std::endl << std::endl;
         else if (m->Get_Flags() & EXTERNAL) os << ";" << std::endl << std::endl;
-        else os << " " << m->Get_Code() << std::endl << std::endl;
+        else if ((options & OPT_TRACE) && cpp_IsTraced(m)) {
+            os << " { AST_TRACE_SCOPE(" << (m->Get_Flags()&STATIC?"-1":"_tag") << ", "
+                    << cpp_TraceId(node, m) << "); " << m->Get_Code() << " }" << std::endl << std::endl;
+        } else os << " " << m->Get_Code() << std::endl << std::endl;
     }
 }
 
@@ -406,9 +1293,24 @@ static void cpp_EmitFactoryFunc(std::ofstream &os, Node *node)
     //
     // -- create a new object
     //    -------------------
-    os << " { return new " << node->Get_Name()->Get_Name() << "(";
-    cpp_EmitConstructorArgs(os, node);
-    os << "); }" << std::endl;
+    if (options & (OPT_STATS | OPT_INDEX)) {
+        os << " {" << std::endl;
+        os << "\t\t" << node->Get_Name()->Get_Name() << " *rv = new " << node->Get_Name()->Get_Name() << "(";
+        cpp_EmitConstructorArgs(os, node);
+        os << ");" << std::endl;
+        if (options & OPT_STATS) {
+            os << "\t\tAST_STATS_CREATED(NODE_TYPE_" << node->Get_Name()->Get_Name() << ");" << std::endl;
+        }
+        if (options & OPT_INDEX) {
+            os << "\t\tASTIndex::Register(rv, NODE_TYPE_" << node->Get_Name()->Get_Name() << ");" << std::endl;
+        }
+        os << "\t\treturn rv;" << std::endl;
+        os << "\t}" << std::endl;
+    } else {
+        os << " { return new " << node->Get_Name()->Get_Name() << "(";
+        cpp_EmitConstructorArgs(os, node);
+        os << "); }" << std::endl;
+    }
     os << std::endl;
 }
 
@@ -447,29 +1349,78 @@ static void cpp_EmitGetTypeString(std::ofstream &os, Node *node)
 }
 
 
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitFlattenFunc() -- Emit the Flatten() function of the root of a flattened family; it is defined with the
+//                          ASTFlat class it returns
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitFlattenFunc(std::ofstream &os, Node *node)
+{
+    if (!(node->Get_Flags() & FLATTEN)) return;
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The " << node->Get_Name()->Get_Name() << " flatten function" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tinline ASTFlat<" << node->Get_Name()->Get_Name() << "> Flatten(void) const;" << std::endl << std::endl;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// cpp_EmitCloneFunc() -- Emit the Clone() functions (--clone only), which are defined with ASTClone()
+//-------------------------------------------------------------------------------------------------------------------
+static void cpp_EmitCloneFunc(std::ofstream &os, Node *node)
+{
+    if (!(options & OPT_CLONE)) return;
+
+    std::string name = node->Get_Name()->Get_Name();
+
+    os << "\t//" << std::endl;
+    os << "\t// -- The " << name << " clone functions, which copy the subtree (into an arena with alloc)" << std::endl;
+    os << "\t//---------------------------------------------------------------------------------" << std::endl;
+
+    os << "public:" << std::endl;
+    os << "\tinline " << name << " *Clone(void) const;" << std::endl;
+    os << "\ttemplate <class A> inline " << name << " *Clone(A &alloc) const;" << std::endl << std::endl;
+}
+
+
 //-------------------------------------------------------------------------------------------------------------------
 // cpp_EmitNodeContents() -- Emit the contents of a node definition
 //
 // A node will be emitted in a consistent order:
-// A) Constructor
+// A) Constructor (and the copy constructor when there are immutable nodes, and the literal constructor of a
+//    literal node or its base classes)
 // B) Desctructor
-// C) Attributes
-// D) Methods
-// E) Static Empty() function
-// F) Static Factory() function
-// G) Static _GetType() function
-// H) Static _GetTypeString() function
+// C) Node type tag, child access, parent link, id and digest (root node only)
+// D) Attributes (and the with_ functions of an immutable node)
+// E) Methods
+// F) Static Empty() function
+// G) Static Factory() function
+// H) Static _GetType() function
+// I) Static _GetTypeString() function
+// J) Flatten() function (root of a flattened family only)
+// K) Clone() functions
 //-------------------------------------------------------------------------------------------------------------------
 static void cpp_EmitNodeContents(std::ofstream &os, Node *node)
 {
     cpp_EmitConstructor(os, node);
+    cpp_EmitCopyConstructor(os, node);
+    cpp_EmitLiteralConstructor(os, node);
     cpp_EmitDestructor(os, node);
-    cpp_EmitAttributes(os, node->Get_Attrs());
-    cpp_EmitMethods(os, node->Get_Meths());
+    cpp_EmitTag(os, node);
+    cpp_EmitParentLink(os, node);
+    cpp_EmitId(os, node);
+    cpp_EmitDigestMember(os, node);
+    cpp_EmitAttributes(os, node);
+    cpp_EmitWith(os, node);
+    cpp_EmitMethods(os, node);
     cpp_EmitEmptyFunc(os, node);
     cpp_EmitFactoryFunc(os, node);
     cpp_EmitGetType(os, node);
     cpp_EmitGetTypeString(os, node);
+    cpp_EmitFlattenFunc(os, node);
+    cpp_EmitCloneFunc(os, node);
 }
 
 
@@ -485,7 +1436,7 @@ static void cpp_EmitNodes(std::ofstream &os)
 
     NodeList *nl;
 
-    for (nl = First(nodes); More(nl); nl = Next(nl)) {
+    for (nl = First(declOrder); More(nl); nl = Next(nl)) {
         Node *n = nl->elem();
 
         os << "//-----------------------------------------------------------------------------------------------" << std::endl;
@@ -493,10 +1444,18 @@ static void cpp_EmitNodes(std::ofstream &os)
         os << "//-----------------------------------------------------------------------------------------------" << std::endl;
 
         os << "class " << n->Get_Name()->Get_Name();
+        if (n->Get_Flags() & FINAL) os << " final";
         if (n->Get_Parent()) {
             os << " : public " << n->Get_Parent()->Get_Name()->Get_Name();
         }
         os << " {" << std::endl;
+        os << "\tfriend struct ASTNodeMeta;" << std::endl;
+        os << "\ttemplate <class T> friend struct ASTReflect;" << std::endl;
+        if (HasFlatNodes()) os << "\ttemplate <class T> friend class ASTFlat;" << std::endl;
+        if (options & OPT_DUMP) os << "\tfriend struct ASTDumpAccess;" << std::endl;
+        if (options & OPT_DIGEST) os << "\tfriend struct ASTDigestAccess;" << std::endl;
+        if (options & OPT_CLONE) os << "\tfriend struct ASTCloneAccess;" << std::endl;
+        os << std::endl;
 
         cpp_EmitNodeContents(os, n);
 
@@ -518,20 +1477,81 @@ static void cpp_EmitNodes(std::ofstream &os)
 // The third stage is to emit the class definitions in their entirety.  This will include attributes, inline methods,
 // external method definitions, constructors, and descructors.
 //
+// The fourth stage is to emit the support code that works across all the nodes: the child slot tables and the
+// tree iterators built on them (and the parallel walk, if requested), the reflection tables, the flattened form of
+// the node families, the dumper and reader, the digests, the clones, the side tables, the rewrite rule matcher and
+// the literal trees.  The allocation counters, method tracing, node ids, node index and digest type, if requested,
+// are emitted around the classes since the classes use them and they need the sizes of the classes.
+//
+// With the --variant option, the third stage emits the nodes as plain classes and tagged unions instead, and
+// the only support code is the shared memory segment, if requested.
+//
 // The final stage is to emit the ending code that was established in the AST source.
+//
+// The code is written to a temporary file next to the output, which is renamed over the output at the end.
 //-------------------------------------------------------------------------------------------------------------------
-void cpp_Emit(void)
+bool cpp_Emit(void)
 {
     static std::ofstream os;
-    os.open (outputFile.c_str());
+    std::string tmp = outputFile + ".tmp";
+
+    os.open (tmp.c_str());
 
     cpp_EmitHeader(os);
     cpp_EmitForwards(os);
     cpp_EmitNodeTypes(os);
     cpp_EmitIncludes(os);
-    cpp_EmitNodes(os);
+    cpp_EmitIntern(os);
+    cpp_EmitBits(os);
+
+    if (options & OPT_VARIANT) {
+        cpp_EmitShmTypes(os);
+        cpp_EmitVariant(os);
+        cpp_EmitShm(os);
+    } else {
+        cpp_EmitStats(os);
+        cpp_EmitTrace(os);
+        cpp_EmitIds(os);
+        cpp_EmitIndex(os);
+        cpp_EmitDigestTypes(os);
+        cpp_EmitNodes(os);
+        cpp_EmitStatsTables(os);
+        cpp_EmitTraceTables(os);
+        cpp_EmitChildTables(os);
+        cpp_EmitReflection(os);
+        cpp_EmitParentLinks(os);
+        cpp_EmitChildAccess(os);
+        cpp_EmitOwnership(os);
+        cpp_EmitFlatten(os);
+        cpp_EmitDump(os);
+        cpp_EmitDigest(os);
+        cpp_EmitClone(os);
+        cpp_EmitSideTable(os);
+        cpp_EmitIterators(os);
+        cpp_EmitParallel(os);
+        cpp_EmitRewriter(os);
+        cpp_EmitLiterals(os);
+    }
 
-    os << endingCode;
+    if (endingCode) os << endingCode;
+
+    //
+    // -- the stamp is repeated as the last line, so a check of an output that was cut short fails
+    //    ----------------------------------------------------------------------------------------
+    if (endingCode && *endingCode && endingCode[strlen(endingCode) - 1] != '\n') os << std::endl;
+    os << InputStamp() << std::endl;
 
     os.close();
+
+    //
+    // -- The output is only replaced once all of it is written, so a run that fails part way (or a full disk) never
+    //    leaves a partial file behind with the input stamp of a good one
+    //    -------------------------------------------------------------------------------------------------------
+    if (os.fail() || rename(tmp.c_str(), outputFile.c_str()) != 0) {
+        fprintf(stderr, "Error: Unable to write the output file %s\n", outputFile.c_str());
+        remove(tmp.c_str());
+        return false;
+    }
+
+    return true;
 }
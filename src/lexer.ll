@@ -55,6 +55,22 @@
 // inline
 // static
 // external
+// rewrite
+// when
+// computed
+// immutable
+// owned
+// interned
+// bits
+// flatten
+// lazy
+// literal
+//
+// The keywords from rewrite on are not reserved words.  rewrite, immutable and literal are only keywords at
+// the start of a statement; the specifiers (immutable, flatten, literal, owned, interned, bits, computed and
+// lazy) are only keywords after the type name that follows a ':' (the SPEC start condition); and when is only
+// a keyword in a rewrite pattern.  Everywhere else they are names, so a spec can still declare
+// `node Literal : Common;` or `attr Cond::when : Int;`.
 //
 // (text)
 // name
@@ -67,6 +83,17 @@
 // ----------  -------  -------  ----  -----------------------------------------------------------------------------
 // 2016-03-29    N/A     v0.1    ADCL  second version of the ast language
 // 2016-10-18   #305     v0.1    ADCL  Remove extra "()" in an initializer and allow an empty initializer.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the rewrite and when keywords for the rewrite rules.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the computed keyword.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the immutable keyword.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the owned keyword.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the interned keyword.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the bits keyword.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the flatten keyword.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the lazy keyword.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the literal keyword.
+// 2026-10-18    N/A    v0.1.1   ADCL  Only recognize the new keywords where they can appear.
+// 2026-10-18    N/A    v0.1.1   ADCL  Skip the white space between a keyword and the '(' of its value.
 //
 //=================================================================================================================*/
 
@@ -79,6 +106,8 @@
 
     extern int depth;
     extern int markerCnt;
+    extern int stmtState;
+    extern int valState;
 %}
 
 WS          [ \t]
@@ -93,33 +122,36 @@ LF          (\n|\r|\n\r|\r\n)
 %x          FN2
 %x          VAL
 %x          TYP
+%s          BODY
+%s          REW
+%s          SPEC
 
 %%
 
-<TYP,INITIAL>{WS}   { }
+<INITIAL,BODY,REW,SPEC,TYP>{WS}   { }
 {LF}                { }
 \/\/[^\n\r]*{LF}    { }
 
 "::"                { return TOK_COLONCOLON; }
 ":"                 { BEGIN(TYP); return TOK_COLON; }
-";"                 { return TOK_SEMI; }
-","                 { return TOK_COMMA; }
+";"                 { BEGIN(INITIAL); return TOK_SEMI; }
+","                 { if (YY_START == SPEC) BEGIN(stmtState); return TOK_COMMA; }
 "<"                 { BEGIN(FN1); yymore(); }
 ">"                 { yylval.msg = "extra '>' character when not expecting"; return TOK_ERROR; }
-"("                 { return TOK_LPAREN; }
-")"                 { return TOK_RPAREN; }
+"("                 { if (YY_START == SPEC) BEGIN(stmtState); return TOK_LPAREN; }
+")"                 { if (YY_START == SPEC) BEGIN(stmtState); return TOK_RPAREN; }
 "{"                 { BEGIN(CODE); depth = 1; yymore(); }
 "}"                 { yylval.msg = "extra '}' character when not expecting"; return TOK_ERROR; }
-"%%"                { if (++markerCnt >= 2) { BEGIN(DUMP); } return TOK_PCTPCT; }
+"%%"                { BEGIN(++markerCnt >= 2 ? DUMP : INITIAL); return TOK_PCTPCT; }
 \"                  { BEGIN(FN2); yymore(); }
 
 (?i:abstract)       { return TOK_ABSTRACT; }
-(?i:attr)           { return TOK_ATTR; }
-(?i:node)           { return TOK_NODE; }
-(?i:type)           { return TOK_TYPE; }
-(?i:include)        { return TOK_INCLUDE; }
-(?i:meth)           { return TOK_METH; }
-(?i:no-init)        { BEGIN(VAL); depth = 0; return TOK_NOINIT; }
+(?i:attr)           { BEGIN(stmtState = BODY); return TOK_ATTR; }
+(?i:node)           { BEGIN(stmtState = BODY); return TOK_NODE; }
+(?i:type)           { BEGIN(stmtState = BODY); return TOK_TYPE; }
+(?i:include)        { BEGIN(stmtState = BODY); return TOK_INCLUDE; }
+(?i:meth)           { BEGIN(stmtState = BODY); return TOK_METH; }
+(?i:no-init)        { valState = YY_START; BEGIN(VAL); depth = 0; return TOK_NOINIT; }
 (?i:no-inlines)     { return TOK_NOINLINES; }
 (?i:public)         { return TOK_PUBLIC; }
 (?i:protected)      { return TOK_PROTECTED; }
@@ -128,10 +160,28 @@ LF          (\n|\r|\n\r|\r\n)
 (?i:inline)         { return TOK_INLINE; }
 (?i:static)         { return TOK_STATIC; }
 (?i:external)       { return TOK_EXTERNAL; }
-<TYP>(?i:void)      { BEGIN(INITIAL); yylval.name = strdup(yytext); return TOK_NAME; }
 
-<TYP,INITIAL>{LET}({LET}|{DIG})* {
-                        BEGIN(INITIAL); yylval.name = strdup(yytext); return TOK_NAME;
+<INITIAL>(?i:immutable)   { BEGIN(stmtState = BODY); return TOK_IMMUTABLE; }
+<INITIAL>(?i:rewrite)     { BEGIN(stmtState = REW); return TOK_REWRITE; }
+<INITIAL>(?i:literal)     { BEGIN(stmtState = BODY); return TOK_LITERAL; }
+
+<SPEC>(?i:immutable)      { return TOK_IMMUTABLE; }
+<SPEC>(?i:flatten)        { return TOK_FLATTEN; }
+<SPEC>(?i:literal)        { return TOK_LITERAL; }
+<SPEC>(?i:owned)          { return TOK_OWNED; }
+<SPEC>(?i:interned)       { return TOK_INTERNED; }
+<SPEC>(?i:bits)           { valState = YY_START; BEGIN(VAL); depth = 0; return TOK_BITS; }
+<SPEC>(?i:computed)       { valState = YY_START; BEGIN(VAL); depth = 0; return TOK_COMPUTED; }
+<SPEC>(?i:lazy)           { valState = YY_START; BEGIN(VAL); depth = 0; return TOK_LAZY; }
+<SPEC,REW>(?i:when)       { valState = YY_START; BEGIN(VAL); depth = 0; return TOK_WHEN; }
+
+<TYP>(?i:void)      { BEGIN(SPEC); yylval.name = strdup(yytext); return TOK_NAME; }
+<TYP>{LET}({LET}|{DIG})* {
+                        BEGIN(SPEC); yylval.name = strdup(yytext); return TOK_NAME;
+                    }
+
+{LET}({LET}|{DIG})* {
+                        yylval.name = strdup(yytext); return TOK_NAME;
                     }
 
 .                   { BEGIN(INITIAL); yylval.msg = "Unregocnized character"; return TOK_ERROR; }
@@ -164,10 +214,11 @@ LF          (\n|\r|\n\r|\r\n)
 <VAL>")"            { if (--depth == 0) {
                         yylval.code = strdup(yytext + 1);
 						yylval.code[strlen(yylval.code) - 1] = 0;
-                        BEGIN(INITIAL);
+                        BEGIN(valState);
                         return TOK_CODE;
                       } else yymore();
                     }
+<VAL>({WS}|{LF})    { if (depth) yymore(); }
 <VAL><<EOF>>        { yylval.msg = "Unexpected EOF in AST source"; BEGIN(INITIAL); return TOK_ERROR; }
 <VAL>.              { yymore(); }
 
@@ -178,6 +229,8 @@ LF          (\n|\r|\n\r|\r\n)
 
 int depth;
 int markerCnt = 0;
+int stmtState = BODY;
+int valState = INITIAL;
 
 int yywrap(void) { return 1; }
 
@@ -30,6 +30,16 @@
 //    Date     Tracker  Version  Pgmr  Modification
 // ----------  -------  -------  ----  -----------------------------------------------------------------------------
 // 2016-03-29    N/A     v0.1    ADCL  second version of the ast language
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the rewrite rule definitions and their patterns.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add computed attributes.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add immutable nodes; the node specifiers are now a list.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the owned attribute specifier.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the interned attribute specifier.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the bits(N) attribute specifier.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the flatten node specifier.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add lazy attributes.
+// 2026-10-18    N/A    v0.1.1   ADCL  Add the literal node specifier and literal trees.
+// 2026-10-18    N/A    v0.1.1   ADCL  Reject a BITS width that is not a number rather than masking it.
 //
 //=================================================================================================================*/
 
@@ -40,6 +50,8 @@
     #include "ast-cc.hh"
     #include <stdio.h>
     #include <cstring>
+    #include <cstdlib>
+    #include <cctype>
 
     extern int parse_error;
     extern char *curr_file;
@@ -71,6 +83,14 @@
 %token          TOK_METH                "METH"
 %token          TOK_NOINIT              "NO-INIT"
 %token          TOK_NOINLINES           "NO-INLINES"
+%token          TOK_COMPUTED            "COMPUTED"
+%token          TOK_IMMUTABLE           "IMMUTABLE"
+%token          TOK_OWNED               "OWNED"
+%token          TOK_INTERNED            "INTERNED"
+%token          TOK_BITS                "BITS"
+%token          TOK_FLATTEN             "FLATTEN"
+%token          TOK_LAZY                "LAZY"
+%token          TOK_LITERAL             "LITERAL"
 %token          TOK_PUBLIC              "PUBLIC"
 %token          TOK_PROTECTED           "PROTECTED"
 %token          TOK_PRIVATE             "PRIVATE"
@@ -78,6 +98,8 @@
 %token          TOK_INLINE              "INLINE"
 %token          TOK_STATIC              "STATIC"
 %token          TOK_EXTERNAL            "EXTERNAL"
+%token          TOK_REWRITE             "REWRITE"
+%token          TOK_WHEN                "WHEN"
 
 %token  <name>  TOK_NAME                "name"
 %token  <file>  TOK_FILENAME            "filename"
@@ -86,9 +108,11 @@
 %token  <msg>   TOK_ERROR
 
 
-%type   <flags> AttrList AttrSpec MethList MethSpec AttrSpecifiers MethSpecifiers
+%type   <flags> AttrList AttrSpec MethList MethSpec AttrSpecifiers MethSpecifiers NodeSpecList NodeSpec NodeSpecifiers
 %type   <parm>  Parm
 %type   <pLst>  ParmList Parms
+%type   <pat>   Pattern
+%type   <patLst> Patterns
 
 %union {
     const char *msg;
@@ -99,6 +123,8 @@
 
     Parameter *parm;
     ParmList *pLst;
+    Pattern *pat;
+    PatList *patLst;
 }
 
 %%
@@ -118,6 +144,7 @@ declaration
     : nodedeclaration
     | typedeclaration
     | includedeclaration
+    | immutabledeclaration
     | error TOK_SEMI
         {
             parse_error ++;
@@ -149,7 +176,7 @@ nodedeclaration
             nodes = Append(nodes, new NodeList(Node::Factory(p, n), NULL));
         }
 
-    | TOK_NODE TOK_NAME TOK_COLON TOK_NAME TOK_SEMI
+    | TOK_NODE TOK_NAME TOK_COLON TOK_NAME NodeSpecifiers TOK_SEMI
         {
             Symbol *n = NULL;
             Node *p = NULL;
@@ -171,34 +198,52 @@ nodedeclaration
                 n = AddNodeSymbol(std::string($2));
             }
 
-            nodes = Append(nodes, new NodeList(Node::Factory(p, n), NULL));
+            Node *t = Node::Factory(p, n);
+            t->Set_Flag((Flags)$5);
+            nodes = Append(nodes, new NodeList(t, NULL));
         }
 
-        | TOK_NODE TOK_NAME TOK_COLON TOK_NAME TOK_ABSTRACT TOK_SEMI
+NodeSpecifiers
+    : /* empty */
         {
-            Symbol *n = NULL;
-            Node *p = NULL;
-            NodeList *wrk;
+            $$ = 0;
+        }
 
-            for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
-                Node *w = wrk->elem();
+    | NodeSpecList
+        {
+            $$ = $1;
+        }
 
-                if (w->Get_Name()->Get_Name() == std::string($4)) {
-                    p = w;
-                    break;
-                }
-            }
+NodeSpecList
+    : NodeSpec
+        {
+            $$ = $1;
+        }
 
-            if (LookupSymbol(std::string($2))) {
-                parse_error ++;
-                fprintf(stderr, "%d: Node name %s is already defined\n", yylineno, $2);
-            } else {
-                n = AddNodeSymbol(std::string($2));
-            }
+    | NodeSpecList NodeSpec
+        {
+            $$ = $1 | $2;
+        }
 
-            Node *t = Node::Factory(p, n);
-            t->Set_Flag(ABSTRACT);
-            nodes = Append(nodes, new NodeList(t, NULL));
+NodeSpec
+    : TOK_ABSTRACT
+        {
+            $$ = ABSTRACT;
+        }
+
+    | TOK_IMMUTABLE
+        {
+            $$ = IMMUTABLE;
+        }
+
+    | TOK_FLATTEN
+        {
+            $$ = FLATTEN;
+        }
+
+    | TOK_LITERAL
+        {
+            $$ = LITERAL;
         }
 
 typedeclaration
@@ -218,6 +263,12 @@ includedeclaration
             includes = Append(includes, new IncludeList($2, NULL));
         }
 
+immutabledeclaration
+    : TOK_IMMUTABLE TOK_SEMI
+        {
+            options |= OPT_IMMUTABLE;
+        }
+
 definitions
     : /* empty */
     | definitions definition
@@ -225,6 +276,8 @@ definitions
 definition
     : attrdefinition
     | methdefinition
+    | rewritedefinition
+    | literaldefinition
     | error TOK_SEMI
         {
             parse_error ++;
@@ -289,6 +342,66 @@ attrdefinition
             }
         }
 
+    | TOK_ATTR TOK_NAME TOK_COLONCOLON TOK_NAME TOK_COLON TOK_NAME AttrSpecifiers TOK_COMPUTED TOK_CODE TOK_SEMI
+        {
+            Symbol *t = GetSymbol(std::string($6));
+
+            if (!t) {
+                parse_error ++;
+                fprintf(stderr, "%d: Undefined attribute type in method %s::%s\n", yylineno, $2, $4);
+            }
+
+            Attribute *a = Attribute::Factory($4, t);
+            a->Set_Flag((Flags)$7);
+            a->Set_Flag(COMPUTED);
+            a->Set_Code(std::string($9));
+
+            NodeList *wrk;
+
+            for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+                Node *n = wrk->elem();
+                Symbol *s = n->Get_Name();
+
+                if (!s) {
+                    parse_error ++;
+                    fprintf(stderr, "%d: Unknown Node name %s\n", yylineno, $2);
+                } else if (s->Get_Name() == std::string($2)) {
+                    n->Add_Attribute(a);
+                    break;
+                }
+            }
+        }
+
+    | TOK_ATTR TOK_NAME TOK_COLONCOLON TOK_NAME TOK_COLON TOK_NAME AttrSpecifiers TOK_LAZY TOK_CODE TOK_SEMI
+        {
+            Symbol *t = GetSymbol(std::string($6));
+
+            if (!t) {
+                parse_error ++;
+                fprintf(stderr, "%d: Undefined attribute type in method %s::%s\n", yylineno, $2, $4);
+            }
+
+            Attribute *a = Attribute::Factory($4, t);
+            a->Set_Flag((Flags)$7);
+            a->Set_Flag(LAZY);
+            a->Set_Code(std::string($9));
+
+            NodeList *wrk;
+
+            for (wrk = First(nodes); More(wrk); wrk = Next(wrk)) {
+                Node *n = wrk->elem();
+                Symbol *s = n->Get_Name();
+
+                if (!s) {
+                    parse_error ++;
+                    fprintf(stderr, "%d: Unknown Node name %s\n", yylineno, $2);
+                } else if (s->Get_Name() == std::string($2)) {
+                    n->Add_Attribute(a);
+                    break;
+                }
+            }
+        }
+
 AttrSpecifiers
     : /* empty */
         {
@@ -332,6 +445,34 @@ AttrSpec
             $$ = STATIC;
         }
 
+    | TOK_OWNED
+        {
+            $$ = OWNED;
+        }
+
+    | TOK_INTERNED
+        {
+            $$ = INTERNED;
+        }
+
+    | TOK_BITS TOK_CODE
+        {
+            //
+            // -- a width that does not fit its 7 bits is kept as 0, which Semant reports with the other bad widths
+            //    -------------------------------------------------------------------------------------------------
+            char *end;
+            long width = strtol($2, &end, 10);
+
+            while (isspace(*end)) end ++;
+
+            if (end == $2 || *end) {
+                yyerror("The width of a BITS attribute must be a number");
+                width = 0;
+            } else if (width < 0 || width > 0x7f) width = 0;
+
+            $$ = BITS | ((int)width << BITS_SHIFT);
+        }
+
     | TOK_NOINLINES
         {
             $$ = NOINLINES;
@@ -512,6 +653,95 @@ Parm
             $$ = Parameter::Factory(std::string($1), t);
         }
 
+rewritedefinition
+    : TOK_REWRITE Pattern TOK_CODE
+        {
+            rewrites = Append(rewrites, new RewriteList(Rewrite::Factory($2, std::string($3), yylineno), NULL));
+        }
+
+    | TOK_REWRITE Pattern TOK_WHEN TOK_CODE TOK_CODE
+        {
+            Rewrite *r = Rewrite::Factory($2, std::string($5), yylineno);
+            r->Set_Guard(std::string($4));
+            rewrites = Append(rewrites, new RewriteList(r, NULL));
+        }
+
+literaldefinition
+    : TOK_LITERAL TOK_NAME TOK_COLON TOK_NAME TOK_CODE
+        {
+            Symbol *t = GetSymbol(std::string($4));
+
+            if (!t || t->Get_Kind() != NODE) {
+                parse_error ++;
+                fprintf(stderr, "%d: The type of literal tree %s must be a node\n", yylineno, $2);
+            }
+
+            literals = Append(literals, new LiteralList(Literal::Factory(std::string($2), t, std::string($5), yylineno),
+                    NULL));
+        }
+
+Pattern
+    : TOK_NAME
+        {
+            //
+            // -- a name alone is a node kind if it names a node; otherwise it binds a wildcard ('_' binds nothing)
+            //    -------------------------------------------------------------------------------------------------
+            Symbol *k = GetSymbol(std::string($1));
+
+            if (k && k->Get_Kind() == NODE) $$ = Pattern::Factory(std::string(""), k);
+            else if (std::string($1) == "_") $$ = Pattern::Factory(std::string(""), NULL);
+            else $$ = Pattern::Factory(std::string($1), NULL);
+        }
+
+    | TOK_NAME TOK_LPAREN Patterns TOK_RPAREN
+        {
+            Symbol *k = GetSymbol(std::string($1));
+
+            if (!k) {
+                parse_error ++;
+                fprintf(stderr, "%d: Unknown node %s in rewrite pattern\n", yylineno, $1);
+            }
+
+            $$ = Pattern::Factory(std::string(""), k);
+            $$->Set_Args($3);
+        }
+
+    | TOK_NAME TOK_COLON TOK_NAME
+        {
+            Symbol *k = GetSymbol(std::string($3));
+
+            if (!k) {
+                parse_error ++;
+                fprintf(stderr, "%d: Unknown node %s in rewrite pattern\n", yylineno, $3);
+            }
+
+            $$ = Pattern::Factory(std::string($1), k);
+        }
+
+    | TOK_NAME TOK_COLON TOK_NAME TOK_LPAREN Patterns TOK_RPAREN
+        {
+            Symbol *k = GetSymbol(std::string($3));
+
+            if (!k) {
+                parse_error ++;
+                fprintf(stderr, "%d: Unknown node %s in rewrite pattern\n", yylineno, $3);
+            }
+
+            $$ = Pattern::Factory(std::string($1), k);
+            $$->Set_Args($5);
+        }
+
+Patterns
+    : Patterns TOK_COMMA Pattern
+        {
+            $$ = Append($1, new PatList($3, NULL));
+        }
+
+    | Pattern
+        {
+            $$ = new PatList($1, NULL);
+        }
+
 
 %%
 